@@ -0,0 +1,112 @@
+#ifndef WDB_TUI_BENCHMARK_H
+#define WDB_TUI_BENCHMARK_H
+
+#include <wdb/wdb_wabt.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Run an exported function repeatedly, each time on a new instance of the module
+     */
+    class Benchmark {
+    public:
+        struct Sample {
+            // Wall time of the function call in ns
+            uint64_t time = 0;
+            uint64_t instructions = 0;
+        };
+
+        struct Statistics {
+            double min = 0;
+            double max = 0;
+            double median = 0;
+            double mean = 0;
+            double stddev = 0;
+            // Half-width of the 95% confidence interval of the mean
+            double ci95 = 0;
+
+            /**
+             * Compute statistics of values
+             * @param values
+             * @return statistics
+             */
+            static Statistics compute(std::vector<double> values);
+        };
+
+        /**
+         * Construct a benchmark
+         * @param wdbWabt
+         * @param options
+         * @param function exported function name
+         */
+        Benchmark(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, std::string function);
+
+        /**
+         * Run warmup iterations, then measured iterations
+         * @param warmup
+         * @param iterations
+         * @return result
+         */
+        wabt::Result run(int warmup, int iterations);
+
+        /**
+         * Get error message of a failed run
+         * @return message
+         */
+        const std::string& getError() const { return m_error; }
+
+        const std::vector<Sample>& getSamples() const { return m_samples; }
+        const std::string& getFunction() const { return m_function; }
+
+        /**
+         * Get statistics of wall times
+         * @return statistics in ns
+         */
+        Statistics getTimeStatistics() const;
+
+        /**
+         * Get statistics of executed instructions
+         * @return statistics
+         */
+        Statistics getInstructionStatistics() const;
+
+        /**
+         * Write results as JSON
+         * @param fileName
+         * @return true on success
+         */
+        bool save(const std::string &fileName) const;
+    private:
+        wdb::WdbWabt *m_wdbWabt = nullptr;
+        wdb::WdbExecutor::Options m_options;
+        std::string m_function;
+        std::string m_error;
+        int m_warmup = 0;
+        std::vector<Sample> m_samples;
+
+        /**
+         * Time one call on a new instance
+         * @param time
+         * @return result
+         */
+        wabt::Result measureTime(uint64_t &time);
+
+        /**
+         * Count instructions of one call on a new instance
+         * @param instructions
+         * @return result
+         */
+        wabt::Result countInstructions(uint64_t &instructions);
+
+        /**
+         * Set the benchmarked function as main function
+         * @param executor
+         * @return result
+         */
+        wabt::Result setMainFunction(wdb::WdbExecutor *executor);
+    };
+}
+
+#endif
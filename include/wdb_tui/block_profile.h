@@ -0,0 +1,49 @@
+#ifndef WDB_TUI_BLOCK_PROFILE_H
+#define WDB_TUI_BLOCK_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Count basic block executions
+     */
+    class BlockProfile : public TraceListener {
+    public:
+        /**
+         * Clear all counters
+         */
+        void reset();
+
+        void onStart(Tracer &tracer) override;
+        void onBeforeInstruction(Tracer &tracer, int index) override {
+            // Only the first instruction of a block updates its counter
+            if(index >= 0 && tracer.getInstruction(index).blockStart) {
+                uint64_t count = ++m_counts[tracer.getInstruction(index).block];
+                if(count > m_maxCount) {
+                    m_maxCount = count;
+                }
+            }
+        }
+
+        /**
+         * Get number of executions of a block
+         * @param block
+         * @return count
+         */
+        uint64_t getCount(int block) const {
+            return block >= 0 && block < m_counts.size() ? m_counts[block] : 0;
+        }
+
+        /**
+         * Get number of executions of the hottest block
+         * @return count
+         */
+        uint64_t getMaxCount() const { return m_maxCount; }
+    private:
+        std::vector<uint64_t> m_counts;
+        uint64_t m_maxCount = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef WDB_TUI_CALL_GRAPH_PROFILE_H
+#define WDB_TUI_CALL_GRAPH_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Count calls and inclusive time per caller and callee pair
+     */
+    class CallGraphProfile : public TraceListener {
+    public:
+        struct Edge {
+            std::string caller;
+            std::string callee;
+            uint64_t count = 0;
+            uint64_t totalTime = 0;
+        };
+
+        /**
+         * Clear all edges
+         */
+        void reset();
+
+        void onStart(Tracer &tracer) override;
+        void onCall(Tracer &tracer, int function, int callSite) override;
+        void onReturn(Tracer &tracer, int function, uint64_t time) override {
+            if(!m_stack.empty()) {
+                Edge &edge = m_edges[m_stack.back()];
+                edge.count++;
+                edge.totalTime += time;
+                m_stack.pop_back();
+            }
+        }
+
+        /**
+         * Get edges sorted by total time
+         * @return edges
+         */
+        std::vector<Edge> getEdges() const;
+    private:
+        // Caller of the main function
+        static const int ROOT = -2;
+
+        std::vector<std::string> m_names;
+        std::vector<Edge> m_edges;
+        // Edge index by caller and callee
+        std::unordered_map<uint64_t, size_t> m_edgeIndex;
+        // Edge index of every active call
+        std::vector<size_t> m_stack;
+
+        /**
+         * Get name of a function
+         * @param function
+         * @return name
+         */
+        std::string getName(int function) const;
+    };
+}
+
+#endif
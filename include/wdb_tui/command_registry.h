@@ -0,0 +1,124 @@
+#ifndef WDB_TUI_COMMAND_REGISTRY_H
+#define WDB_TUI_COMMAND_REGISTRY_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Table of debugger commands.
+     * Each command declares the type of its arguments, which are
+     * parsed and checked before its handler is called.
+     */
+    class CommandRegistry {
+    public:
+        enum ArgumentType {
+            // Positive integer
+            LINE = 0,
+            // Any word, completed with the registered names
+            NAME,
+            // <space>[<index>].<type>, e.g. stack[0].i32
+            LOCATION
+        };
+
+        struct Location {
+            std::string space;
+            uint32_t index = 0;
+            std::string type;
+        };
+
+        struct Argument {
+            std::string text;
+            // Value of a LINE argument
+            uint64_t number = 0;
+            // Value of a LOCATION argument
+            Location location;
+        };
+
+        typedef std::function<void(const std::vector<Argument> &arguments)> Handler;
+
+        struct Command {
+            std::string name;
+            std::vector<std::string> aliases;
+            std::vector<ArgumentType> arguments;
+            // Argument names shown in help, e.g. "<pc>"
+            std::string usage;
+            std::string help;
+            Handler handler;
+        };
+
+        enum Status {
+            EXECUTED = 0,
+            EMPTY,
+            NOT_FOUND,
+            INVALID_ARGUMENTS
+        };
+
+        /**
+         * Register a command, replaces a command with the same name or alias
+         * @param command
+         */
+        void add(const Command &command);
+
+        /**
+         * Parse and run a command line
+         * @param line
+         * @param error message if the command did not run
+         * @return status
+         */
+        Status execute(const std::string &line, std::string &error) const;
+
+        /**
+         * Complete the last word of a command line
+         * @param line
+         * @param candidates words matching the last word
+         * @return line extended with the common prefix of the candidates
+         */
+        std::string complete(const std::string &line, std::vector<std::string> &candidates) const;
+
+        /**
+         * Set names used to complete NAME arguments
+         * @param names
+         */
+        void setNames(const std::vector<std::string> &names) { m_names = names; }
+
+        /**
+         * Get one help line per command
+         * @return lines
+         */
+        std::vector<std::string> getHelp() const;
+
+        /**
+         * Split a line into words separated by spaces or tabs
+         * @param line
+         * @return words
+         */
+        static std::vector<std::string> split(const std::string &line);
+
+        /**
+         * Parse a positive integer
+         * @param text
+         * @param number
+         * @return true if parsed
+         */
+        static bool parseLine(const std::string &text, uint64_t &number);
+
+        /**
+         * Parse a location such as stack[0].i32
+         * @param text
+         * @param location
+         * @return true if parsed
+         */
+        static bool parseLocation(const std::string &text, Location &location);
+    private:
+        std::vector<Command> m_commands;
+        // Command index of every name and alias
+        std::unordered_map<std::string, size_t> m_index;
+        std::vector<std::string> m_names;
+    };
+}
+
+#endif
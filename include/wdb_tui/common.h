@@ -15,5 +15,9 @@
 #define WDB_COLOR_SUCCESS 2
 #define WDB_COLOR_ERROR 3
 #define WDB_COLOR_INFO 4
+#define WDB_COLOR_HEAT_1 5
+#define WDB_COLOR_HEAT_2 6
+#define WDB_COLOR_HEAT_3 7
+#define WDB_COLOR_HEAT_4 8
 
 #endif
@@ -0,0 +1,116 @@
+#ifndef WDB_TUI_CONSOLE_H
+#define WDB_TUI_CONSOLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Fixed-capacity ring of console lines.
+     * Writes without a trailing newline are coalesced into an open last line,
+     * the oldest lines are dropped once the ring is full. With a spill file,
+     * every line is appended to it once complete, an open line on clear()
+     * or destruction, so the whole output is kept on disk.
+     */
+    class Console {
+    public:
+        static const size_t DEFAULT_CAPACITY = 10000;
+        // An open line is closed once it reaches this length
+        static const size_t MAX_LINE_LENGTH = 4096;
+
+        /**
+         * Construct an empty console
+         * @param capacity maximum number of lines kept in memory
+         */
+        explicit Console(size_t capacity = DEFAULT_CAPACITY);
+
+        /**
+         * Spill the open line
+         */
+        ~Console();
+
+        /**
+         * Append output text, lines are split on '\n' and
+         * text without a trailing newline stays open for the next write
+         * @param text
+         */
+        void write(const std::string &text);
+
+        /**
+         * Append a complete line, an open line is closed first
+         * @param line
+         */
+        void addLine(const std::string &line);
+
+        /**
+         * Remove all lines kept in memory, the open line is spilled first
+         */
+        void clear();
+
+        /**
+         * Append lines to a file as they are completed
+         * @param fileName
+         * @return true if the file was opened
+         */
+        bool setSpillFile(const std::string &fileName);
+
+        /**
+         * Get line by index, 0 is the oldest line kept in memory
+         * @param index
+         * @return line
+         */
+        const std::string& getLine(size_t index) const { return m_lines[(m_first + index) % m_lines.size()]; }
+
+        /**
+         * Copy a range of lines
+         * @param first index of the first line
+         * @param count maximum number of lines
+         * @return lines
+         */
+        std::vector<std::string> getLines(size_t first, size_t count) const;
+
+        /**
+         * Get number of lines kept in memory
+         * @return count
+         */
+        size_t getSize() const { return m_size; }
+
+        /**
+         * Get number of lines dropped from the ring
+         * @return count
+         */
+        uint64_t getDropped() const { return m_dropped; }
+
+        size_t getCapacity() const { return m_lines.size(); }
+    private:
+        std::vector<std::string> m_lines;
+        size_t m_first = 0;
+        size_t m_size = 0;
+        // Last line still receives writes
+        bool m_open = false;
+        uint64_t m_dropped = 0;
+        std::ofstream m_spill;
+
+        /**
+         * Close the open line and spill it
+         */
+        void closeLine();
+
+        /**
+         * Append a complete line to the spill file if one is set
+         * @param line
+         */
+        void spill(const std::string &line);
+
+        /**
+         * Start a new line, dropping the oldest one if the ring is full
+         * @return new line
+         */
+        std::string& pushLine();
+    };
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef WDB_TUI_COVERAGE_PROFILE_H
+#define WDB_TUI_COVERAGE_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Record executed instructions in a bitmap, one bit per instruction start
+     */
+    class CoverageProfile : public TraceListener {
+    public:
+        struct FunctionCoverage {
+            std::string name;
+            int covered = 0;
+            int total = 0;
+        };
+
+        void onStart(Tracer &tracer) override;
+        void onBeforeInstruction(Tracer &tracer, int index) override {
+            if(index >= 0) {
+                m_bitmap[index >> 6] |= 1ULL << (index & 63);
+            }
+        }
+
+        /**
+         * Check if an instruction was executed in this run
+         * @param index
+         * @return true if executed
+         */
+        bool isCovered(int index) const {
+            return index >= 0 && (index >> 6) < m_bitmap.size() && (m_bitmap[index >> 6] >> (index & 63)) & 1;
+        }
+
+        /**
+         * Get number of runs that executed an instruction, including previous merged runs
+         * @param index
+         * @return runs
+         */
+        uint32_t getHits(int index) const;
+
+        /**
+         * Merge an lcov tracefile written by a previous run of the same module
+         * @param fileName
+         * @param tracer
+         * @return true on success
+         */
+        bool load(const std::string &fileName, const Tracer &tracer);
+
+        /**
+         * Write an lcov tracefile, lines are the disassembly lines shown in the debugger
+         * @param fileName
+         * @param sourceName
+         * @param tracer
+         * @return true on success
+         */
+        bool save(const std::string &fileName, const std::string &sourceName, const Tracer &tracer) const;
+
+        /**
+         * Write the istream offset of every covered instruction, one per line
+         * @param fileName
+         * @param tracer
+         * @return true on success
+         */
+        bool saveOffsets(const std::string &fileName, const Tracer &tracer) const;
+
+        /**
+         * Get coverage of each function
+         * @param tracer
+         * @return coverage
+         */
+        std::vector<FunctionCoverage> getFunctionCoverage(const Tracer &tracer) const;
+    private:
+        std::vector<uint64_t> m_bitmap;
+        // Hits from previous runs
+        std::vector<uint32_t> m_previousHits;
+    };
+}
+
+#endif
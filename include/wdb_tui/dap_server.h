@@ -0,0 +1,159 @@
+#ifndef WDB_TUI_DAP_SERVER_H
+#define WDB_TUI_DAP_SERVER_H
+
+#include <wdb_tui/debug_session.h>
+#include <wdb_tui/json.h>
+#include <wdb/wdb_wabt.h>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace wdb {
+    /**
+     * Debug Adapter Protocol server for a debug session.
+     * The source of the single stack frame is the module disassembly, one
+     * instruction per line, so breakpoint lines are instruction lines. The
+     * stack is paged with indexed variables and memories are read with
+     * readMemory using the references 'memory<index>'.
+     */
+    class DapServer {
+    public:
+        // Largest readMemory reply, longer reads are truncated
+        static const uint64_t MAX_MEMORY_READ = 0x100000;
+        // Largest accepted message body, a longer Content-Length is a protocol error
+        static const uint64_t MAX_MESSAGE_LENGTH = 0x1000000;
+
+        /**
+         * Construct a server and its debug session
+         * @param wdbWabt
+         * @param options only preSetup is used
+         * @param sourceName name of the disassembly shown by the editor
+         * @param in
+         * @param out receives protocol messages only
+         */
+        DapServer(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, const std::string &sourceName,
+                  std::istream &in, std::ostream &out);
+
+        DapServer(const DapServer&) = delete;
+        DapServer& operator=(const DapServer&) = delete;
+
+        /**
+         * Answer requests until the client disconnects
+         * @param error
+         * @return true if the client sent a disconnect request
+         */
+        bool serve(std::string &error);
+
+        /**
+         * Get the debug session
+         * @return session
+         */
+        DebugSession& getSession() { return *m_session; }
+
+        /**
+         * Set the function to debug when the launch request does not name one
+         * @param name exported function
+         */
+        void setMainFunction(const std::string &name) { m_mainFunction = name; }
+    private:
+        // Variable references of the scopes
+        enum Reference {
+            STACK_REFERENCE = 1,
+            MEMORIES_REFERENCE
+        };
+
+        std::unique_ptr<DebugSession> m_session;
+        std::string m_sourceName;
+        std::istream &m_in;
+        std::ostream &m_out;
+        int m_sequence = 1;
+        std::string m_mainFunction;
+        bool m_launched = false;
+        bool m_configured = false;
+        bool m_stopOnEntry = false;
+        bool m_terminated = false;
+        // Messages of an evaluate request, sent as its result instead of output events
+        bool m_capture = false;
+        std::string m_captured;
+
+        /**
+         * Read the next message
+         * @param message
+         * @param error set on a protocol error, empty at the end of input
+         * @return false at the end of input or on a malformed header
+         */
+        bool readMessage(Json &message, std::string &error);
+
+        /**
+         * Send a message, numbering it
+         * @param message
+         */
+        void send(Json message);
+
+        /**
+         * Send a response
+         * @param request
+         * @param body
+         * @param error message if the request failed, empty on success
+         */
+        void respond(const Json &request, const Json &body, const std::string &error = "");
+
+        /**
+         * Send an event
+         * @param name
+         * @param body
+         */
+        void event(const std::string &name, const Json &body);
+
+        /**
+         * Answer a request
+         * @param request
+         * @return false if the client disconnects
+         */
+        bool handleRequest(const Json &request);
+
+        /**
+         * Start executing once the client is launched and configured
+         */
+        void start();
+
+        /**
+         * Step or continue and report where execution stopped
+         * @param command debugger command
+         * @param reason stop reason if the program did not return
+         */
+        void resume(const std::string &command, const std::string &reason);
+
+        /**
+         * Send a stopped event, or exited and terminated events once main has returned
+         * @param reason
+         */
+        void reportStop(const std::string &reason);
+
+        /**
+         * Get the source of the frame
+         * @return source
+         */
+        Json getSource() const;
+
+        /**
+         * Get a page of variables
+         * @param reference
+         * @param start
+         * @param count 0 for all
+         * @return variables, empty for an unknown reference
+         */
+        Json getVariables(uint64_t reference, uint64_t start, uint64_t count) const;
+
+        /**
+         * Encode bytes in base64
+         * @param data
+         * @param size
+         * @return text
+         */
+        static std::string toBase64(const uint8_t *data, size_t size);
+    };
+}
+
+#endif
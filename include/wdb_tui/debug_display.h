@@ -2,7 +2,10 @@
 #define WDB_TUI_DEBUG_DISPLAY_H
 
 #include <wdb_tui/display.h>
+#include <wdb_tui/console.h>
+#include <wdb_tui/debug_session.h>
 #include <wdb/wdb_wabt.h>
+#include <memory>
 
 namespace wdb {
     class DebugDisplay : public Display {
@@ -11,8 +14,10 @@ namespace wdb {
          * Construct debug display
          * @param wdbWabt
          * @param options
+         * @param moduleIndex index shared with other displays, null to index the module in the display
          */
-        DebugDisplay(wdb::WdbWabt* wdbWabt, wdb::WdbExecutor::Options options);
+        DebugDisplay(wdb::WdbWabt* wdbWabt, wdb::WdbExecutor::Options options,
+                     wdb::ModuleIndex *moduleIndex = nullptr);
 
         /**
          * Listen for user input
@@ -25,10 +30,14 @@ namespace wdb {
          * @return vector of code
          */
         std::vector<std::string> generateDebugCode();
+
+        /**
+         * Append all console lines to a file
+         * @param fileName
+         */
+        void setConsoleSpillFile(const std::string &fileName);
     private:
-        wdb::WdbWabt *m_wdbWabt = nullptr;
-        wdb::WdbExecutor::Options m_executorOptions;
-        wdb::WdbDebuggerExecutor *m_executor = nullptr;
+        std::unique_ptr<wdb::DebugSession> m_session;
         enum Panel {
             STACK = 0,
             CODE,
@@ -46,18 +55,46 @@ namespace wdb {
         std::vector<std::vector<char>> m_commandHistory;
         int m_currentCommandIndex = 0;
         int m_commandHistoryScroll = 0;
-        std::vector<std::string> m_consoleOutput;
+        wdb::Console m_console;
         int m_consoleTopIndex = 0;
 
         // Code screen variables
-        std::vector<wdb::WdbDebuggerExecutor::Instruction> m_instructions;
-        std::set<int> m_breakLine;
         int m_codeTopIndex = 0;
         int m_codeHighlightLineIndex = 0;
+        bool m_heatMap = false;
 
         // Stack variables
         int m_stackLeftIndex = 0;
         int m_stackHighlightColIndex = 0;
+        enum StackView {
+            STACK_HEX = 0,
+            STACK_I32,
+            STACK_I64,
+            STACK_F32,
+            STACK_F64,
+            STACK_I8X16,
+            STACK_I16X8,
+            STACK_I32X4,
+            STACK_F32X4,
+            STACK_VIEW_COUNT
+        };
+        StackView m_stackView = STACK_HEX;
+        // Formatted stack values, from the bottom of the stack
+        struct StackSlot {
+            wabt::interp::Value value;
+            StackView view = STACK_HEX;
+            std::vector<std::string> lines;
+        };
+        std::vector<StackSlot> m_stackSlots;
+        // Lines of a formatted stack value
+        static const int STACK_VALUE_LINES = 4;
+
+        /**
+         * Get heat map color of a block
+         * @param count block executions
+         * @return color
+         */
+        short getHeatColor(uint64_t count) const;
 
         /**
          * Get memory memory at byte
@@ -72,64 +109,67 @@ namespace wdb {
         void updateStack();
 
         /**
-         * Update code screen
+         * Format a stack value
+         * @param value
+         * @param view
+         * @return STACK_VALUE_LINES lines
          */
-        void updateCode();
+        static std::vector<std::string> formatStackValue(const wabt::interp::Value &value, StackView view);
 
         /**
-         * Update memory screen
+         * Get column width of a stack view
+         * @param view
+         * @return number of columns
          */
-        void updateMemory();
+        static int getStackViewCols(StackView view);
 
         /**
-         * Update command screen
+         * Get name of a stack view
+         * @param view
+         * @return name
          */
-        void updateCommand();
+        static const char* getStackViewName(StackView view);
 
         /**
-         * Update all screens
+         * Update code screen
          */
-        void update();
+        void updateCode();
 
         /**
-         * Handle user command
-         * @param command
+         * Update memory screen
          */
-        void handleCommand(std::string command);
+        void updateMemory();
 
         /**
-         * Reset debugger variables
+         * Update command screen
          */
-        void reset();
+        void updateCommand();
 
         /**
-         * Output stream handler
+         * Update all screens
          */
-        void outputStreamHandler(std::string text);
+        void update();
 
         /**
-         * Error stream handler
-         * @param text
+         * Register commands only available in the tui
          */
-        void errorStreamHandler(std::string text);
+        void registerCommands();
 
         /**
-         * Add breakpoint
-         * @param line
+         * Handle user command
+         * @param command
          */
-        bool addBreakpoint(int line);
+        void handleCommand(std::string command);
 
         /**
-         * Remove breakpoint
-         * @param line
+         * Complete the command being typed
          */
-        bool removeBreakpoint(int line);
+        void completeCommand();
 
         /**
-         * List all breakpoints
-         * @return breakpoints
+         * Reset debugger variables
          */
-        std::set<int> getBreakpoints() const { return m_breakLine; }
+        void reset();
     };
 }
 
@@ -0,0 +1,125 @@
+#ifndef WDB_TUI_DEBUG_SESSION_H
+#define WDB_TUI_DEBUG_SESSION_H
+
+#include <wdb_tui/tracer.h>
+#include <wdb_tui/block_profile.h>
+#include <wdb_tui/command_registry.h>
+#include <wdb_tui/module_index.h>
+#include <wdb/wdb_wabt.h>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Debugger state and commands, independent of how they are shown.
+     * Program output and command messages are reported through handlers,
+     * so the same session runs inside the tui or headless.
+     */
+    class DebugSession {
+    public:
+        typedef std::function<void(const std::string &text)> Handler;
+        typedef std::vector<CommandRegistry::Argument> Arguments;
+
+        /**
+         * Construct a session and create its first executor
+         * @param wdbWabt
+         * @param options only preSetup is used
+         * @param outputHandler receives program output, possibly partial lines
+         * @param messageHandler receives complete lines written by commands and errors
+         * @param moduleIndex index shared with other displays, null to index the module in the session
+         */
+        DebugSession(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, Handler outputHandler,
+                     Handler messageHandler, wdb::ModuleIndex *moduleIndex = nullptr);
+
+        DebugSession(const DebugSession&) = delete;
+        DebugSession& operator=(const DebugSession&) = delete;
+
+        /**
+         * Create a new executor and its tracer, breakpoints are kept
+         * @return true if the executor was created
+         */
+        bool restart();
+
+        /**
+         * Parse and run a command line, errors are reported as messages
+         * @param line
+         * @return status
+         */
+        CommandRegistry::Status execute(const std::string &line);
+
+        /**
+         * Add breakpoint
+         * @param line instruction line starting at 1
+         * @return true if the line exists
+         */
+        bool addBreakpoint(int line);
+
+        /**
+         * Remove breakpoint
+         * @param line instruction line starting at 1
+         * @return true if the line exists
+         */
+        bool removeBreakpoint(int line);
+
+        /**
+         * Get line of the instruction about to execute
+         * @return line starting at 1, 0 if not found
+         */
+        int getCurrentLine() const;
+
+        /**
+         * Get line of an instruction
+         * @param offset instruction offset in the istream
+         * @return line starting at 1, 0 if not found
+         */
+        int getLine(uint32_t offset) const;
+
+        /**
+         * Count basic blocks, 'continue' then steps through the tracer instead of running the executor
+         * @param enabled
+         */
+        void setTraceBlocks(bool enabled);
+
+        /**
+         * Write a message line
+         * @param text
+         */
+        void message(const std::string &text) { m_messageHandler(text); }
+
+        /**
+         * Get commands, new commands can be registered
+         * @return commands
+         */
+        CommandRegistry& getCommands() { return m_commands; }
+
+        wdb::WdbDebuggerExecutor* getExecutor() const { return m_executor; }
+        wdb::Tracer* getTracer() const { return m_tracer.get(); }
+        const wdb::BlockProfile& getBlockProfile() const { return m_blockProfile; }
+        const std::vector<wdb::WdbDebuggerExecutor::Instruction>& getInstructions() const { return m_instructions; }
+        const std::set<int>& getBreakpoints() const { return m_breakLine; }
+    private:
+        wdb::WdbWabt *m_wdbWabt = nullptr;
+        wdb::WdbExecutor::Options m_executorOptions;
+        wdb::WdbDebuggerExecutor *m_executor = nullptr;
+        std::unique_ptr<wdb::Tracer> m_tracer;
+        wdb::ModuleIndex *m_moduleIndex = nullptr;
+        wdb::ModuleIndex m_ownModuleIndex;
+        wdb::BlockProfile m_blockProfile;
+        bool m_traceBlocks = false;
+        std::vector<wdb::WdbDebuggerExecutor::Instruction> m_instructions;
+        std::set<int> m_breakLine;
+        CommandRegistry m_commands;
+        Handler m_outputHandler;
+        Handler m_messageHandler;
+
+        /**
+         * Register debugger commands
+         */
+        void registerCommands();
+    };
+}
+
+#endif
@@ -10,6 +10,8 @@ namespace wdb {
     protected:
         CDKSCREEN* m_CDKScreen = nullptr;
         bool m_focus = false;
+        // Name of the display in frame stats, empty if frames are not recorded
+        std::string m_frameName;
         enum Highlight {
             HLINE = 0,
             HCOLUMN,
@@ -33,10 +35,16 @@ namespace wdb {
         virtual ~Display();
 
         /**
-         * Draw display
+         * Draw display, ends the frame started by getInput()
          */
         void draw();
 
+        /**
+         * Wait for a key and start a frame, toggles the frame stats overlay on F12
+         * @return key
+         */
+        int getInput();
+
         /**
          * Draw border
          * @param topLeftY
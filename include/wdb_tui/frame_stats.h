@@ -0,0 +1,161 @@
+#ifndef WDB_TUI_FRAME_STATS_H
+#define WDB_TUI_FRAME_STATS_H
+
+#include <wdb_tui/latency_histogram.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Frame times of the tui displays.
+     * A frame starts when wgetch returns and ends when draw() returns,
+     * panel updates inside a frame are recorded as sections of it.
+     * Each section keeps a histogram of the whole session and a window
+     * of the latest frames for rolling percentiles.
+     */
+    class FrameStats {
+    public:
+        // Number of latest frames used for rolling percentiles
+        static const size_t WINDOW = 128;
+
+        struct Section {
+            std::string name;
+            LatencyHistogram histogram;
+            std::vector<uint64_t> window;
+            size_t next = 0;
+
+            /**
+             * Record a duration
+             * @param time in ns
+             */
+            void record(uint64_t time);
+
+            /**
+             * Get percentile over the latest frames
+             * @param percentile between 0 and 100
+             * @return time in ns
+             */
+            uint64_t getRollingPercentile(double percentile) const;
+        };
+
+        /**
+         * Get the process-wide frame stats
+         * @return frame stats
+         */
+        static FrameStats& get();
+
+        /**
+         * Enable recording
+         * @param enabled
+         */
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+
+        /**
+         * Check if frames are recorded
+         * @return true if enabled
+         */
+        bool isEnabled() const { return m_enabled; }
+
+        /**
+         * Show or hide the overlay, showing it also enables recording
+         */
+        void toggleOverlay() {
+            m_overlay = !m_overlay;
+            m_enabled = m_enabled || m_overlay;
+        }
+
+        /**
+         * Check if the overlay is shown
+         * @return true if shown
+         */
+        bool isOverlayVisible() const { return m_overlay; }
+
+        /**
+         * Start a frame after an input event
+         * @param display display name
+         */
+        void beginFrame(const std::string &display);
+
+        /**
+         * End the current frame, ignored if no frame started
+         */
+        void endFrame();
+
+        /**
+         * Check if a frame is being recorded
+         * @return true if recording
+         */
+        bool inFrame() const { return m_inFrame; }
+
+        /**
+         * Record a section of the current frame, ignored outside of a frame
+         * @param section section name
+         * @param time in ns
+         */
+        void recordSection(const std::string &section, uint64_t time);
+
+        /**
+         * Get a one-line summary of the rolling percentiles of the current display
+         * @return summary
+         */
+        std::string getSummary() const;
+
+        /**
+         * Print percentiles of every display and section
+         * @param out
+         */
+        void print(std::ostream &out) const;
+    private:
+        struct DisplayStats {
+            Section frame;
+            // Sections in the order they were first recorded
+            std::vector<Section> sections;
+        };
+
+        std::map<std::string, DisplayStats> m_displays;
+        DisplayStats *m_current = nullptr;
+        std::chrono::steady_clock::time_point m_frameStart;
+        bool m_inFrame = false;
+        bool m_enabled = false;
+        bool m_overlay = false;
+    };
+
+    /**
+     * Record the lifetime of a scope as a section of the current frame
+     */
+    class ScopedFrameSection {
+    public:
+        /**
+         * Start timing
+         * @param name section name
+         */
+        explicit ScopedFrameSection(const char *name) : m_name(name), m_active(FrameStats::get().inFrame()) {
+            if(m_active) {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        /**
+         * Stop timing
+         */
+        ~ScopedFrameSection() {
+            if(m_active) {
+                FrameStats::get().recordSection(m_name, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - m_start).count());
+            }
+        }
+
+        ScopedFrameSection(const ScopedFrameSection&) = delete;
+        ScopedFrameSection& operator=(const ScopedFrameSection&) = delete;
+    private:
+        const char *m_name;
+        bool m_active;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+#endif
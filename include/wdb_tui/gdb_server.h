@@ -0,0 +1,168 @@
+#ifndef WDB_TUI_GDB_SERVER_H
+#define WDB_TUI_GDB_SERVER_H
+
+#include <wdb_tui/debug_session.h>
+#include <wdb/wdb_wabt.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * GDB remote serial protocol stub for a debug session.
+     * Registers are the pc, the stack size and the values on top of the
+     * stack, addresses of m/x packets are offsets in memory 0 and addresses
+     * of Z0 packets are instruction offsets. Debugger commands such as
+     * 'main <func>' are run with 'monitor'.
+     */
+    class GdbServer {
+    public:
+        // Largest packet accepted and sent, advertised in qSupported
+        static const size_t PACKET_SIZE = 0x20000;
+        // Stack values exposed as registers, from the top of the stack
+        static const int STACK_REGISTERS = 16;
+
+        /**
+         * Construct a server and its debug session
+         * @param wdbWabt
+         * @param options only preSetup is used
+         */
+        GdbServer(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options);
+
+        /**
+         * Close sockets
+         */
+        ~GdbServer();
+
+        GdbServer(const GdbServer&) = delete;
+        GdbServer& operator=(const GdbServer&) = delete;
+
+        /**
+         * Listen on a local address
+         * @param address unix:<path>, <host>:<port> or <port>, hosts other than localhost are refused
+         * @param error
+         * @return true if listening
+         */
+        bool listen(const std::string &address, std::string &error);
+
+        /**
+         * Accept one client and answer its packets until it detaches, kills or disconnects
+         * @param error
+         * @return true if the client detached or killed the program
+         */
+        bool serve(std::string &error);
+
+        /**
+         * Get the debug session
+         * @return session
+         */
+        DebugSession& getSession() { return *m_session; }
+    private:
+        std::unique_ptr<DebugSession> m_session;
+        int m_listenSocket = -1;
+        int m_socket = -1;
+        std::string m_unixPath;
+        std::string m_input;
+        size_t m_inputPosition = 0;
+        bool m_noAck = false;
+        // Client accepts binary replies to x packets with a 'b' prefix
+        bool m_binaryUpload = false;
+        // Console text waiting to be sent in O packets
+        std::string m_console;
+
+        /**
+         * Read one byte from the client
+         * @param c
+         * @return false if disconnected
+         */
+        bool readByte(char &c);
+
+        /**
+         * Read the next packet, acknowledging it unless in no-ack mode
+         * @param packet payload, "\x03" for an interrupt
+         * @return false if disconnected
+         */
+        bool readPacket(std::string &packet);
+
+        /**
+         * Send a packet
+         * @param payload already escaped
+         * @return false if disconnected
+         */
+        bool sendPacket(const std::string &payload);
+
+        /**
+         * Send pending console text as O packets
+         * @return false if disconnected
+         */
+        bool flushConsole();
+
+        /**
+         * Answer a packet
+         * @param packet
+         * @param reply
+         * @return false if the session ends
+         */
+        bool handlePacket(const std::string &packet, std::string &reply);
+
+        /**
+         * Answer a q or Q packet
+         * @param packet
+         * @return reply, empty if unsupported
+         */
+        std::string handleQuery(const std::string &packet);
+
+        /**
+         * Get the stop reply after stepping or continuing
+         * @return reply
+         */
+        std::string getStopReply() const;
+
+        /**
+         * Encode all registers for a g packet
+         * @return hex
+         */
+        std::string readRegisters() const;
+
+        /**
+         * Encode one register
+         * @param index
+         * @return hex, x for unavailable bytes
+         */
+        std::string readRegister(int index) const;
+
+        /**
+         * Copy memory 0 into a buffer
+         * @param address
+         * @param length
+         * @param bytes
+         * @return false if the address is outside the memory
+         */
+        bool readMemory(uint64_t address, uint64_t length, std::vector<uint8_t> &bytes) const;
+
+        /**
+         * Get target description
+         * @return xml
+         */
+        static std::string getTargetDescription();
+
+        /**
+         * Encode bytes as hex
+         * @param data
+         * @param size
+         * @return hex
+         */
+        static std::string toHex(const uint8_t *data, size_t size);
+
+        /**
+         * Escape binary data for a packet
+         * @param data
+         * @param size
+         * @return escaped data
+         */
+        static std::string escape(const uint8_t *data, size_t size);
+    };
+}
+
+#endif
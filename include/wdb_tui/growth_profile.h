@@ -0,0 +1,116 @@
+#ifndef WDB_TUI_GROWTH_PROFILE_H
+#define WDB_TUI_GROWTH_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Record linear memory growth and peak usage
+     */
+    class GrowthProfile : public TraceListener {
+    public:
+        static const int WASM_PAGE_BITS = 16;
+
+        struct Event {
+            uint32_t memory = 0;
+            // Instructions executed before the grow
+            uint64_t instructionCount = 0;
+            // Wall time since the start of the run in ns
+            uint64_t timestamp = 0;
+            std::string function;
+            uint32_t previousPages = 0;
+            uint32_t requestedPages = 0;
+            uint32_t pages = 0;
+
+            bool succeeded() const { return pages == previousPages + requestedPages; }
+        };
+
+        struct Usage {
+            uint32_t initialPages = 0;
+            uint32_t peakPages = 0;
+            // Highest page touched by a load or a store, plus one
+            uint32_t touchedHighWater = 0;
+            uint32_t touchedPages = 0;
+        };
+
+        /**
+         * Clear all events
+         */
+        void reset();
+
+        void onStart(Tracer &tracer) override;
+        void onBeforeInstruction(Tracer &tracer, int index) override {
+            if(index >= 0) {
+                auto &instruction = tracer.getInstruction(index);
+                if(instruction.kind == Tracer::LOAD || instruction.kind == Tracer::STORE) {
+                    recordAccess(tracer, instruction);
+                } else if(instruction.kind == Tracer::MEMORY_GROW) {
+                    beginGrow(tracer, instruction);
+                }
+            }
+        }
+        void onAfterInstruction(Tracer &tracer, int index, uint64_t time) override {
+            if(index >= 0 && tracer.getInstruction(index).kind == Tracer::MEMORY_GROW) {
+                endGrow(tracer);
+            }
+        }
+
+        /**
+         * Get grow events in executed order
+         * @return events
+         */
+        const std::vector<Event>& getEvents() const { return m_events; }
+
+        /**
+         * Get usage of every memory
+         * @return usage
+         */
+        const std::vector<Usage>& getUsage() const { return m_usage; }
+
+        /**
+         * Write grow events as a CSV timeline
+         * @param fileName
+         * @return true on success
+         */
+        bool save(const std::string &fileName) const;
+    private:
+        std::chrono::steady_clock::time_point m_startTime;
+        std::vector<Event> m_events;
+        std::vector<Usage> m_usage;
+        std::vector<std::vector<bool>> m_touched;
+        Event m_pending;
+
+        /**
+         * Record the page touched by a load or a store
+         * @param tracer
+         * @param instruction
+         */
+        void recordAccess(Tracer &tracer, const Tracer::Instruction &instruction);
+
+        /**
+         * Record the state before a memory grow
+         * @param tracer
+         * @param instruction
+         */
+        void beginGrow(Tracer &tracer, const Tracer::Instruction &instruction);
+
+        /**
+         * Record the state after a memory grow
+         * @param tracer
+         */
+        void endGrow(Tracer &tracer);
+
+        /**
+         * Get current number of pages of a memory
+         * @param tracer
+         * @param memory
+         * @return pages
+         */
+        static uint32_t getPages(Tracer &tracer, uint32_t memory);
+    };
+}
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef WDB_TUI_HEAP_PROFILE_H
+#define WDB_TUI_HEAP_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Track allocations made through the module's own malloc and free
+     */
+    class HeapProfile : public TraceListener {
+    public:
+        /**
+         * Allocator functions, given as an export name or '#' followed by the function index in the module,
+         * imports counted as in the wasm index space
+         */
+        struct Hooks {
+            std::string malloc;
+            std::string calloc;
+            std::string realloc;
+            std::string free;
+
+            bool empty() const { return malloc.empty() && calloc.empty() && realloc.empty() && free.empty(); }
+        };
+
+        struct Site {
+            std::string name;
+            uint64_t allocations = 0;
+            uint64_t bytes = 0;
+            uint64_t liveAllocations = 0;
+            uint64_t liveBytes = 0;
+        };
+
+        struct Summary {
+            uint64_t allocations = 0;
+            uint64_t frees = 0;
+            uint64_t bytes = 0;
+            uint64_t liveAllocations = 0;
+            uint64_t liveBytes = 0;
+            uint64_t peakLiveBytes = 0;
+            // Frees of pointers that were never allocated
+            uint64_t invalidFrees = 0;
+        };
+
+        /**
+         * Parse hooks from "malloc=<func>,free=<func>[,calloc=<func>][,realloc=<func>]"
+         * @param text
+         * @param hooks
+         * @return true on success
+         */
+        static bool parseHooks(const std::string &text, Hooks &hooks);
+
+        /**
+         * Construct a heap profile
+         * @param hooks
+         */
+        explicit HeapProfile(const Hooks &hooks = Hooks()) : m_hooks(hooks) {}
+
+        /**
+         * Clear all allocations
+         */
+        void reset();
+
+        void onStart(Tracer &tracer) override;
+        void onCall(Tracer &tracer, int function, int callSite) override {
+            if(function >= 0 && function < m_functionKinds.size() && m_functionKinds[function] != NONE) {
+                enterAllocator(tracer, function, callSite);
+            }
+        }
+        void onReturn(Tracer &tracer, int function, uint64_t time) override {
+            if(!m_pending.empty() && m_pending.back().depth == tracer.getCallDepth() + 1) {
+                leaveAllocator(tracer);
+            }
+        }
+
+        /**
+         * Check if the hooks were found in the module
+         * @return true if at least one hook was resolved
+         */
+        bool isEnabled() const { return m_enabled; }
+
+        /**
+         * Get allocation sites sorted by live bytes then bytes
+         * @return sites
+         */
+        std::vector<Site> getSites() const;
+
+        /**
+         * Get totals
+         * @return summary
+         */
+        const Summary& getSummary() const { return m_summary; }
+
+        /**
+         * Write summary, sites and leaked allocations
+         * @param fileName
+         * @return true on success
+         */
+        bool save(const std::string &fileName) const;
+    private:
+        enum Kind {
+            NONE = 0,
+            MALLOC,
+            CALLOC,
+            REALLOC,
+            FREE
+        };
+
+        struct Allocation {
+            uint64_t size;
+            int site;
+        };
+
+        struct Pending {
+            Kind kind;
+            int depth;
+            int site;
+            // calloc sizes are a product of two i32 arguments
+            uint64_t size;
+            uint32_t previous;
+        };
+
+        Hooks m_hooks;
+        bool m_enabled = false;
+        std::vector<Kind> m_functionKinds;
+        std::vector<Pending> m_pending;
+        std::unordered_map<uint32_t, Allocation> m_live;
+        std::unordered_map<int, Site> m_sites;
+        Summary m_summary;
+
+        /**
+         * Resolve a hook to a traced function
+         * @param tracer
+         * @param hook
+         * @param kind
+         */
+        void resolveHook(Tracer &tracer, const std::string &hook, Kind kind);
+
+        /**
+         * Read arguments of an allocator call
+         * @param tracer
+         * @param function
+         * @param callSite
+         */
+        void enterAllocator(Tracer &tracer, int function, int callSite);
+
+        /**
+         * Read result of an allocator call
+         * @param tracer
+         */
+        void leaveAllocator(Tracer &tracer);
+
+        /**
+         * Record a new allocation
+         * @param pointer
+         * @param size
+         * @param site
+         */
+        void allocate(uint32_t pointer, uint64_t size, int site);
+
+        /**
+         * Record a released allocation
+         * @param pointer
+         */
+        void release(uint32_t pointer);
+    };
+}
+
+#endif
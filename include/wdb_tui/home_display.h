@@ -10,6 +10,12 @@ namespace wdb {
     public:
         HomeDisplay();
         ~HomeDisplay();
+
+        /**
+         * Show a message at the bottom of the home screen
+         * @param message
+         */
+        void setStatus(std::string message);
     };
 }
 #endif
@@ -0,0 +1,145 @@
+#ifndef WDB_TUI_JSON_H
+#define WDB_TUI_JSON_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Minimal JSON value with a parser and a serializer
+     */
+    class Json {
+    public:
+        enum Type {
+            NUL = 0,
+            BOOL,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        Json() {}
+        Json(bool value) : m_type(BOOL), m_bool(value) {}
+        Json(int value) : m_type(NUMBER), m_number(value) {}
+        Json(uint32_t value) : m_type(NUMBER), m_number(value) {}
+        Json(int64_t value) : m_type(NUMBER), m_number((double) value) {}
+        Json(uint64_t value) : m_type(NUMBER), m_number((double) value) {}
+        Json(double value) : m_type(NUMBER), m_number(value) {}
+        Json(const char *value) : m_type(STRING), m_string(value) {}
+        Json(const std::string &value) : m_type(STRING), m_string(value) {}
+
+        /**
+         * Create an empty array
+         * @return array
+         */
+        static Json array() { Json json; json.m_type = ARRAY; return json; }
+
+        /**
+         * Create an empty object
+         * @return object
+         */
+        static Json object() { Json json; json.m_type = OBJECT; return json; }
+
+        /**
+         * Parse a JSON document
+         * @param text
+         * @param value parsed value
+         * @return true on success
+         */
+        static bool parse(const std::string &text, Json &value);
+
+        /**
+         * Serialize value
+         * @param indent spaces per level, 0 for a single line
+         * @return text
+         */
+        std::string dump(int indent = 0) const;
+
+        Type getType() const { return m_type; }
+        bool isNull() const { return m_type == NUL; }
+        bool isNumber() const { return m_type == NUMBER; }
+        bool isString() const { return m_type == STRING; }
+        bool isArray() const { return m_type == ARRAY; }
+        bool isObject() const { return m_type == OBJECT; }
+
+        bool asBool() const { return m_type == BOOL && m_bool; }
+        double asNumber() const { return m_type == NUMBER ? m_number : 0; }
+
+        /**
+         * Get a number as an integer, truncated and clamped to the range of the type
+         * @return integer, 0 if not a number or NaN
+         */
+        int64_t asInt() const;
+
+        /**
+         * Get a number as an unsigned integer, truncated and clamped to the range of the type
+         * @return integer, 0 if not a number, negative or NaN
+         */
+        uint64_t asUint() const;
+
+        const std::string& asString() const { return m_string; }
+
+        /**
+         * Append to an array
+         * @param value
+         */
+        void push(const Json &value) { m_type = ARRAY; m_array.push_back(value); }
+
+        /**
+         * Get number of array elements or object members
+         * @return size
+         */
+        size_t size() const { return m_type == OBJECT ? m_object.size() : m_array.size(); }
+
+        /**
+         * Get array element
+         * @param index
+         * @return element
+         */
+        const Json& operator[](size_t index) const { return m_array[index]; }
+
+        /**
+         * Get or insert an object member
+         * @param key
+         * @return member
+         */
+        Json& operator[](const std::string &key) { m_type = OBJECT; return m_object[key]; }
+
+        /**
+         * Get an object member
+         * @param key
+         * @return member, null if missing
+         */
+        const Json& get(const std::string &key) const;
+
+        /**
+         * Check if an object has a member
+         * @param key
+         * @return true if present
+         */
+        bool has(const std::string &key) const { return m_object.find(key) != m_object.end(); }
+
+        const std::vector<Json>& getArray() const { return m_array; }
+        const std::map<std::string, Json>& getObject() const { return m_object; }
+    private:
+        Type m_type = NUL;
+        bool m_bool = false;
+        double m_number = 0;
+        std::string m_string;
+        std::vector<Json> m_array;
+        std::map<std::string, Json> m_object;
+
+        /**
+         * Serialize value
+         * @param out
+         * @param indent
+         * @param level nesting level
+         */
+        void dump(std::string &out, int indent, int level) const;
+    };
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef WDB_TUI_LATENCY_HISTOGRAM_H
+#define WDB_TUI_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+namespace wdb {
+    /**
+     * Log-linear (HDR-style) histogram of nanosecond latencies.
+     * Each power of two is split into SUB_BUCKETS linear buckets, which keeps
+     * the relative error under 1/SUB_BUCKETS while the storage stays fixed.
+     */
+    class LatencyHistogram {
+    public:
+        static const int SUB_BUCKET_BITS = 4;
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int MAX_VALUE_BITS = 40;
+        static const int BUCKETS = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+        static const uint64_t MAX_VALUE = (1ULL << MAX_VALUE_BITS) - 1;
+
+        /**
+         * Construct an empty histogram
+         */
+        LatencyHistogram() { reset(); }
+
+        /**
+         * Record a value
+         * @param value
+         */
+        void record(uint64_t value) {
+            if(value > m_max) {
+                m_max = value;
+            }
+            if(value < m_min) {
+                m_min = value;
+            }
+            if(value > MAX_VALUE) {
+                value = MAX_VALUE;
+            }
+            m_buckets[bucketIndex(value)]++;
+            m_count++;
+        }
+
+        /**
+         * Clear all recorded values
+         */
+        void reset();
+
+        /**
+         * Add values recorded by another histogram
+         * @param other
+         */
+        void merge(const LatencyHistogram &other);
+
+        /**
+         * Get value at percentile
+         * @param percentile between 0 and 100
+         * @return highest value equivalent to the bucket holding the percentile
+         */
+        uint64_t getPercentile(double percentile) const;
+
+        /**
+         * Get number of recorded values
+         * @return count
+         */
+        uint64_t getCount() const { return m_count; }
+
+        /**
+         * Get largest recorded value
+         * @return max
+         */
+        uint64_t getMax() const { return m_max; }
+
+        /**
+         * Get smallest recorded value
+         * @return min
+         */
+        uint64_t getMin() const { return m_count == 0 ? 0 : m_min; }
+
+        /**
+         * Get bucket index of a value
+         * @param value
+         * @return index
+         */
+        static int bucketIndex(uint64_t value) {
+            if(value < SUB_BUCKETS) {
+                return (int) value;
+            }
+            int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+            return (shift << SUB_BUCKET_BITS) + (int) (value >> shift);
+        }
+
+        /**
+         * Get highest value held by a bucket
+         * @param index
+         * @return value
+         */
+        static uint64_t bucketUpperBound(int index);
+    private:
+        std::array<uint64_t, BUCKETS> m_buckets;
+        uint64_t m_count;
+        uint64_t m_min;
+        uint64_t m_max;
+    };
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef WDB_TUI_MAPPED_FILE_H
+#define WDB_TUI_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wdb {
+    /**
+     * Read-only memory mapping of a whole file
+     */
+    class MappedFile {
+    public:
+        /**
+         * Map a file
+         * @param fileName
+         */
+        explicit MappedFile(const std::string &fileName);
+
+        /**
+         * Unmap the file
+         */
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * Check if the file was opened
+         * @return true if opened, an empty file is opened but not mapped
+         */
+        bool isOpen() const { return m_open; }
+
+        const uint8_t* getData() const { return m_data; }
+        size_t getSize() const { return m_size; }
+    private:
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+    };
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef WDB_TUI_MEMORY_PROFILE_H
+#define WDB_TUI_MEMORY_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Count loads and stores per memory page, and optionally per cache line
+     */
+    class MemoryProfile : public TraceListener {
+    public:
+        static const int PAGE_BITS = 12;
+        static const int LINE_BITS = 6;
+
+        struct Region {
+            uint32_t memory = 0;
+            uint64_t index = 0;
+            uint64_t reads = 0;
+            uint64_t writes = 0;
+
+            uint64_t getAddress(int bits) const { return index << bits; }
+        };
+
+        /**
+         * Construct a memory profile
+         * @param lines also count accesses per 64-byte line
+         */
+        explicit MemoryProfile(bool lines = false) : m_lines(lines) {}
+
+        /**
+         * Clear all counters
+         */
+        void reset() { m_memories.clear(); }
+
+        void onStart(Tracer &tracer) override;
+        void onBeforeInstruction(Tracer &tracer, int index) override {
+            if(index >= 0) {
+                auto &instruction = tracer.getInstruction(index);
+                if(instruction.kind == Tracer::LOAD || instruction.kind == Tracer::STORE) {
+                    recordAccess(tracer, instruction);
+                }
+            }
+        }
+
+        /**
+         * Get most accessed pages
+         * @param k
+         * @return regions sorted by accesses
+         */
+        std::vector<Region> getHottestPages(int k) const;
+
+        /**
+         * Get most accessed lines
+         * @param k
+         * @return regions sorted by accesses
+         */
+        std::vector<Region> getHottestLines(int k) const;
+
+        /**
+         * Write every accessed page and line
+         * @param fileName
+         * @return true on success
+         */
+        bool save(const std::string &fileName) const;
+    private:
+        struct Counters {
+            std::vector<uint64_t> pageReads;
+            std::vector<uint64_t> pageWrites;
+            std::vector<uint64_t> lineReads;
+            std::vector<uint64_t> lineWrites;
+        };
+
+        bool m_lines;
+        std::vector<Counters> m_memories;
+
+        /**
+         * Record a load or a store
+         * @param tracer
+         * @param instruction
+         */
+        void recordAccess(Tracer &tracer, const Tracer::Instruction &instruction);
+
+        /**
+         * Resize counters to the memory size
+         * @param tracer
+         * @param memory
+         */
+        void resize(Tracer &tracer, uint32_t memory);
+
+        /**
+         * Select the k most accessed regions
+         * @param lines select lines instead of pages
+         * @param k
+         * @return regions sorted by accesses
+         */
+        std::vector<Region> getHottest(bool lines, int k) const;
+    };
+}
+
+#endif
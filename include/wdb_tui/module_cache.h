@@ -0,0 +1,100 @@
+#ifndef WDB_TUI_MODULE_CACHE_H
+#define WDB_TUI_MODULE_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+namespace wdb {
+    /**
+     * On-disk cache of results derived from a module.
+     * The loader only reads modules from a file and cannot restore a decoded one,
+     * so only load errors and generated text are cached. Load errors are keyed by
+     * file identity, which costs a stat instead of hashing every valid module.
+     * Both keys include the loader version.
+     */
+    class ModuleCache {
+    public:
+        // Bump when the layout of cached entries changes
+        static const int VERSION = 2;
+
+        /**
+         * Construct a cache
+         * @param directory cache directory, created on first write
+         */
+        explicit ModuleCache(const std::string &directory = getDefaultDirectory());
+
+        /**
+         * Get $XDG_CACHE_HOME/wdb_tui, or ~/.cache/wdb_tui
+         * @return directory, empty if neither variable is set
+         */
+        static std::string getDefaultDirectory();
+
+        /**
+         * Get the version of the loader that produced cached results
+         * @return version
+         */
+        static const char* getLoaderVersion();
+
+        /**
+         * Hash module contents
+         * @param data
+         * @param size
+         * @return key
+         */
+        static std::string getKey(const uint8_t *data, size_t size);
+
+        /**
+         * Hash path, size and modification time of a module file
+         * @param fileName
+         * @return key, empty if the file cannot be read
+         */
+        static std::string getFileKey(const std::string &fileName);
+
+        /**
+         * Check if a module failed to load before
+         * @param key file key
+         * @param error load error recorded for the module
+         * @return true if the module is known to be invalid
+         */
+        bool isInvalid(const std::string &key, std::string &error) const;
+
+        /**
+         * Record that a module failed to load
+         * @param key file key
+         * @param error
+         */
+        void setInvalid(const std::string &key, const std::string &error);
+
+        /**
+         * Read a cached text
+         * @param key
+         * @param name entry name
+         * @param text
+         * @return true on hit
+         */
+        bool loadText(const std::string &key, const std::string &name, std::string &text) const;
+
+        /**
+         * Write a text to the cache
+         * @param key
+         * @param name entry name
+         * @param text
+         * @return true on success
+         */
+        bool saveText(const std::string &key, const std::string &name, const std::string &text);
+
+        bool isEnabled() const { return !m_directory.empty(); }
+    private:
+        std::string m_directory;
+
+        /**
+         * Get path of an entry
+         * @param key
+         * @param name
+         * @return path
+         */
+        std::string getPath(const std::string &key, const std::string &name) const;
+    };
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef WDB_TUI_MODULE_INDEX_H
+#define WDB_TUI_MODULE_INDEX_H
+
+#include <wdb/wdb_wabt.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Exported functions of a loaded module and its imports, indexed once.
+     * Function indices are the same in every executor created from the same
+     * module, so one index serves all of them. Build it before sharing it
+     * between threads.
+     * The module binary, when read, also gives the main module's defined
+     * functions, including those that are not exported, and their names from
+     * the name section.
+     */
+    class ModuleIndex {
+    public:
+        struct Function {
+            // "<main>" for the main module
+            std::string module;
+            std::string name;
+            wabt::Index index = 0;
+            // Comma separated types, "<empty>" if there are none
+            std::string params;
+            std::string results;
+            size_t paramCount = 0;
+            bool isHost = false;
+            bool canRun = false;
+        };
+
+        /**
+         * Index exported functions, does nothing if already built
+         * @param executor
+         */
+        void build(wdb::WdbExecutor *executor);
+
+        /**
+         * Read the function layout of the main module binary, call before build()
+         * @param data
+         * @param size
+         * @return false if the binary is malformed
+         */
+        bool readBinary(const uint8_t *data, size_t size);
+
+        /**
+         * Check if the index was built
+         * @return true if built
+         */
+        bool isBuilt() const { return m_built; }
+
+        /**
+         * Check if defined functions of the main module can be enumerated
+         * @return true if the binary was read and matched the executor's exports
+         */
+        bool hasDefinedFunctions() const { return m_built && m_hasBinary && m_definedBase >= 0; }
+
+        wabt::Index getImportedFunctionCount() const { return m_importedFunctionCount; }
+        wabt::Index getDefinedFunctionCount() const { return m_definedFunctionCount; }
+
+        /**
+         * Get a defined function of the main module in an executor
+         * @param executor
+         * @param index position among defined functions, imports not counted
+         * @return function, null if out of range or not enumerable
+         */
+        wabt::interp::Func* getDefinedFunction(wdb::WdbExecutor *executor, wabt::Index index) const;
+
+        /**
+         * Get the name section name of a function
+         * @param index function index in the main module, imports counted
+         * @return name, empty if none
+         */
+        std::string getFunctionName(wabt::Index index) const;
+
+        /**
+         * Get exported functions of all modules, in module order
+         * @return functions
+         */
+        const std::vector<Function>& getFunctions() const { return m_functions; }
+
+        /**
+         * Find an exported function of the main module
+         * @param name
+         * @return function, null if not found
+         */
+        const Function* find(const std::string &name) const;
+
+        /**
+         * Find an exported function of the main module in an executor
+         * @param executor
+         * @param name
+         * @return function, null if not found
+         */
+        wabt::interp::Func* getFunction(wdb::WdbExecutor *executor, const std::string &name) const;
+
+        /**
+         * Get names of exported functions of the main module
+         * @return names
+         */
+        std::vector<std::string> getNames() const;
+
+        /**
+         * Get names of exported functions of the main module that can run without arguments
+         * @return names
+         */
+        std::vector<std::string> getRunnableNames() const;
+    private:
+        bool m_built = false;
+        std::vector<Function> m_functions;
+        // Export name in the main module to position in m_functions
+        std::unordered_map<std::string, size_t> m_mainExports;
+        bool m_hasBinary = false;
+        wabt::Index m_importedFunctionCount = 0;
+        wabt::Index m_definedFunctionCount = 0;
+        // Function exports and names of the binary, by function index in the module
+        std::unordered_map<std::string, wabt::Index> m_binaryExports;
+        std::unordered_map<wabt::Index, std::string> m_functionNames;
+        // Executor index of the first defined function, -1 if unknown
+        int64_t m_definedBase = -1;
+
+        /**
+         * Format a list of types
+         * @param types
+         * @return comma separated types, "<empty>" if there are none
+         */
+        static std::string formatTypes(const wabt::TypeVector &types);
+    };
+}
+
+#endif
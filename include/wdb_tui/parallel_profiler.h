@@ -0,0 +1,93 @@
+#ifndef WDB_TUI_PARALLEL_PROFILER_H
+#define WDB_TUI_PARALLEL_PROFILER_H
+
+#include <wdb_tui/module_index.h>
+#include <wdb_tui/timing_profile.h>
+#include <wdb/wdb_wabt.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Profile many exported functions at once, each on its own executor
+     */
+    class ParallelProfiler {
+    public:
+        struct Run {
+            std::string function;
+            bool succeeded = false;
+            uint64_t instructions = 0;
+            // Time spent in instructions in ns
+            uint64_t time = 0;
+            // Wall time of the run including tracing in ns
+            uint64_t wallTime = 0;
+        };
+
+        /**
+         * Construct a parallel profiler
+         * @param wdbWabt
+         * @param options
+         * @param threads number of workers, 0 for one per hardware thread
+         * @param moduleIndex index shared with other users, null to index the module in the profiler
+         */
+        ParallelProfiler(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, int threads = 0,
+                         wdb::ModuleIndex *moduleIndex = nullptr);
+
+        /**
+         * Get exported functions of the main module that take no arguments
+         * @return function names, empty if the module could not be indexed
+         */
+        std::vector<std::string> getRunnableFunctions();
+
+        /**
+         * Profile functions and merge their results
+         * @param functions
+         */
+        void run(const std::vector<std::string> &functions);
+
+        /**
+         * Get runs in the order functions were given
+         * @return runs
+         */
+        const std::vector<Run>& getRuns() const { return m_runs; }
+
+        /**
+         * Get results merged over all runs
+         * @return profile
+         */
+        const TimingProfile& getProfile() const { return m_profile; }
+
+        /**
+         * Get wall time of the last run() in ns
+         * @return time
+         */
+        uint64_t getWallTime() const { return m_wallTime; }
+
+        int getThreadCount() const { return m_threads; }
+    private:
+        wdb::WdbWabt *m_wdbWabt = nullptr;
+        wdb::WdbExecutor::Options m_options;
+        int m_threads = 0;
+        wdb::ModuleIndex *m_moduleIndex = nullptr;
+        wdb::ModuleIndex m_ownModuleIndex;
+        std::vector<Run> m_runs;
+        TimingProfile m_profile;
+        uint64_t m_wallTime = 0;
+        // Guards executor creation and the merged profile
+        std::mutex m_mutex;
+
+        /**
+         * Build the module index from one executor if it is not built yet
+         */
+        void buildIndex();
+
+        /**
+         * Profile one function
+         * @param run
+         */
+        void profile(Run &run);
+    };
+}
+
+#endif
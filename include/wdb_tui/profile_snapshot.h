@@ -0,0 +1,139 @@
+#ifndef WDB_TUI_PROFILE_SNAPSHOT_H
+#define WDB_TUI_PROFILE_SNAPSHOT_H
+
+#include <wdb_tui/timing_profile.h>
+#include <wdb_tui/call_graph_profile.h>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Profiling results of one run that can be saved, loaded and compared
+     */
+    class ProfileSnapshot {
+    public:
+        static const int VERSION = 1;
+
+        struct Record {
+            std::string name;
+            uint64_t count = 0;
+            uint64_t totalTime = 0;
+            uint64_t instructions = 0;
+        };
+
+        struct Delta {
+            std::string category;
+            std::string name;
+            Record base;
+            Record current;
+            // Unmatched records exist in only one of the snapshots
+            bool inBase = false;
+            bool inCurrent = false;
+
+            int64_t getCountDelta() const { return (int64_t) current.count - (int64_t) base.count; }
+            int64_t getTimeDelta() const { return (int64_t) current.totalTime - (int64_t) base.totalTime; }
+
+            /**
+             * Get time delta relative to the base
+             * @return percentage, 100 for records missing from the base
+             */
+            double getRelativeTimeDelta() const {
+                return base.totalTime == 0 ? (current.totalTime == 0 ? 0 : 100)
+                                           : 100.0 * getTimeDelta() / base.totalTime;
+            }
+        };
+
+        struct Check {
+            // Function name, or "<total>" for the whole run
+            std::string name;
+            std::string metric;
+            uint64_t base = 0;
+            uint64_t current = 0;
+            bool regressed = false;
+            // Baseline function that did not run
+            bool missing = false;
+
+            /**
+             * Get delta relative to the base
+             * @return percentage, 0 if the base is empty
+             */
+            double getRelativeDelta() const {
+                return base == 0 ? 0 : 100.0 * ((double) current - (double) base) / base;
+            }
+        };
+
+        // Functions below this share of the baseline run time are too noisy to gate on time
+        static constexpr double MIN_TIME_SHARE = 1.0;
+
+        /**
+         * Capture results of a finished run
+         * @param function name of the profiled function
+         * @param tracer
+         * @param timingProfile
+         * @param callGraphProfile
+         */
+        void capture(const std::string &function, const Tracer &tracer, const TimingProfile &timingProfile,
+                     const CallGraphProfile &callGraphProfile);
+
+        /**
+         * Write snapshot as JSON
+         * @param fileName
+         * @return true on success
+         */
+        bool save(const std::string &fileName) const;
+
+        /**
+         * Read snapshot from a JSON file
+         * @param fileName
+         * @param error reason of a failure
+         * @return true on success
+         */
+        bool load(const std::string &fileName, std::string &error);
+
+        /**
+         * Compare two snapshots
+         * @param base
+         * @param current
+         * @return deltas of all records including unmatched ones, largest time regression first
+         */
+        static std::vector<Delta> diff(const ProfileSnapshot &base, const ProfileSnapshot &current);
+
+        /**
+         * Check the whole run and every baseline function for instruction and time regressions,
+         * an empty base value is never a regression
+         * @param base
+         * @param current
+         * @param threshold allowed increase in percent
+         * @return checks, regressions first, then baseline functions missing from the current run
+         */
+        static std::vector<Check> compare(const ProfileSnapshot &base, const ProfileSnapshot &current,
+                                          double threshold);
+
+        const std::string& getFunction() const { return m_function; }
+        uint64_t getInstructionCount() const { return m_instructionCount; }
+        uint64_t getElapsedTime() const { return m_elapsedTime; }
+        const std::vector<Record>& getOpcodes() const { return m_opcodes; }
+        const std::vector<Record>& getFunctions() const { return m_functions; }
+        const std::vector<Record>& getCalls() const { return m_calls; }
+    private:
+        std::string m_function;
+        uint64_t m_instructionCount = 0;
+        uint64_t m_elapsedTime = 0;
+        std::vector<Record> m_opcodes;
+        std::vector<Record> m_functions;
+        // Call graph edges named "caller -> callee"
+        std::vector<Record> m_calls;
+
+        /**
+         * Pair records of the same name
+         * @param category
+         * @param base
+         * @param current
+         * @param deltas
+         */
+        static void diffRecords(const std::string &category, const std::vector<Record> &base,
+                                const std::vector<Record> &current, std::vector<Delta> &deltas);
+    };
+}
+
+#endif
@@ -2,26 +2,73 @@
 #define WDB_TUI_PROFILER_DISPLAY_H
 
 #include <wdb_tui/display.h>
+#include <wdb_tui/timing_profile.h>
+#include <wdb_tui/sequence_profile.h>
+#include <wdb_tui/memory_profile.h>
+#include <wdb_tui/growth_profile.h>
+#include <wdb_tui/heap_profile.h>
+#include <wdb_tui/stack_profile.h>
+#include <wdb_tui/call_graph_profile.h>
+#include <wdb_tui/profile_snapshot.h>
+#include <wdb_tui/parallel_profiler.h>
+#include <wdb_tui/module_index.h>
 #include <wdb/wdb_wabt.h>
 
 namespace wdb {
     class ProfilerDisplay : public Display {
     private:
         wdb::WdbProfilerExecutor::Sort m_listSort;
-        wdb::WdbProfilerExecutor *m_executor = nullptr;
+        wdb::WdbDebuggerExecutor *m_executor = nullptr;
         wdb::WdbWabt* m_wdbWabt = nullptr;
         wdb::WdbExecutor::Options m_executorOptions;
+        wdb::ModuleIndex *m_moduleIndex = nullptr;
+        wdb::ModuleIndex m_ownModuleIndex;
         enum Panel {
             FUNCTIONS = 0,
             RESULTS
         };
         Panel m_focusPanel;
+        enum ResultView {
+            VIEW_OPCODES = 0,
+            VIEW_FUNCTIONS,
+            VIEW_PAIRS,
+            VIEW_TRIPLES,
+            VIEW_MEMORY,
+            VIEW_GROWTH,
+            VIEW_HEAP,
+            VIEW_STACK,
+            VIEW_CALLS,
+            VIEW_DIFF,
+            VIEW_EXPORTS,
+            VIEW_COUNT
+        };
+        ResultView m_resultView = VIEW_OPCODES;
+
+        // Profiling results
+        wdb::TimingProfile m_timingProfile;
+        wdb::SequenceProfile m_sequenceProfile;
+        wdb::MemoryProfile m_memoryProfile;
+        wdb::GrowthProfile m_growthProfile;
+        wdb::HeapProfile m_heapProfile;
+        wdb::StackProfile m_stackProfile;
+        wdb::CallGraphProfile m_callGraphProfile;
+        // Results of the last run
+        wdb::ProfileSnapshot m_snapshot;
+        bool m_hasSnapshot = false;
+        // Profiles loaded from files, compared with each other or with the last run
+        std::vector<wdb::ProfileSnapshot> m_loadedProfiles;
+        // Runs of the last profile all
+        std::vector<wdb::ParallelProfiler::Run> m_parallelRuns;
+        uint64_t m_parallelWallTime = 0;
+        static const int TOP_SEQUENCES = 100;
+        static const int TOP_PAGES = 100;
 
         // Function list screen
         int m_funcHighlight = 0;
         int m_funcTopIndex = 0;
         int m_funcLeftIndex = 0;
-        std::vector<wabt::interp::Export> m_funcList;
+        // Rows of the function table, built once from the module index
+        std::vector<std::vector<std::string>> m_funcData;
 
         // Data list screen
         int m_dataHighlight = 0;
@@ -43,6 +90,15 @@ namespace wdb {
          */
         void updateDataList();
 
+        /**
+         * Populate profiler data table for the selected view
+         * @param title
+         * @param header
+         * @param data
+         */
+        void getResultData(std::string &title, std::vector<std::string> &header,
+                           std::vector<std::vector<std::string>> &data);
+
         /**
          * Update status
          * @param color
@@ -55,13 +111,38 @@ namespace wdb {
          * Execute a function
          */
         void executeFunction();
+
+        /**
+         * Profile all runnable functions in parallel and merge their results
+         */
+        void executeAllFunctions();
+
+        /**
+         * Clear results of previous runs
+         */
+        void resetResults();
+
+        /**
+         * Save results of the last run
+         */
+        void saveSnapshot();
     public:
         /**
          * Construct profiler display
          * @param wdbWabt
-         * @param wdbWabt
+         * @param options
+         * @param heapHooks allocator functions to track
+         * @param moduleIndex index shared with other displays, null to index the module in the display
+         */
+        ProfilerDisplay(wdb::WdbWabt* wdbWabt, wdb::WdbExecutor::Options options,
+                        const wdb::HeapProfile::Hooks &heapHooks = wdb::HeapProfile::Hooks(),
+                        wdb::ModuleIndex *moduleIndex = nullptr);
+
+        /**
+         * Add a saved profile to compare, the first added profile is the baseline
+         * @param snapshot
          */
-        ProfilerDisplay(wdb::WdbWabt* wdbWabt, wdb::WdbExecutor::Options options);
+        void addProfile(const wdb::ProfileSnapshot &snapshot) { m_loadedProfiles.push_back(snapshot); }
 
         /**
          * Listen for user input
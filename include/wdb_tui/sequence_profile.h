@@ -0,0 +1,101 @@
+#ifndef WDB_TUI_SEQUENCE_PROFILE_H
+#define WDB_TUI_SEQUENCE_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Count adjacent opcode pairs and triples in executed order
+     */
+    class SequenceProfile : public TraceListener {
+    public:
+        // Triples need opcodes^3 counters, skip them above this many distinct opcodes
+        static const int MAX_TRIPLE_OPCODES = 128;
+
+        struct Sequence {
+            std::string name;
+            uint64_t count = 0;
+        };
+
+        /**
+         * Clear all counters
+         */
+        void reset();
+
+        void onStart(Tracer &tracer) override;
+        void onAfterInstruction(Tracer &tracer, int index, uint64_t time) override {
+            int id = index < 0 ? m_unknownId : m_opcodeIds[index];
+            if(m_previous >= 0) {
+                m_pairs[m_previous * m_numOpcodes + id]++;
+                if(m_beforePrevious >= 0) {
+                    if(m_triples.empty()) {
+                        m_droppedTriples++;
+                    } else {
+                        m_triples[(m_beforePrevious * m_numOpcodes + m_previous) * m_numOpcodes + id]++;
+                    }
+                }
+            }
+            m_beforePrevious = m_previous;
+            m_previous = id;
+            m_total++;
+        }
+
+        /**
+         * Get most frequent opcode pairs
+         * @param k
+         * @return sequences sorted by count
+         */
+        std::vector<Sequence> getTopPairs(int k) const;
+
+        /**
+         * Get most frequent opcode triples
+         * @param k
+         * @return sequences sorted by count
+         */
+        std::vector<Sequence> getTopTriples(int k) const;
+
+        /**
+         * Check if triples were counted
+         * @return true if counted
+         */
+        bool hasTriples() const { return !m_triples.empty(); }
+
+        /**
+         * Get number of executed triples that were not counted
+         * @return count, 0 if triples were counted
+         */
+        uint64_t getDroppedTriples() const { return m_droppedTriples; }
+
+        /**
+         * Get number of executed instructions
+         * @return count
+         */
+        uint64_t getTotal() const { return m_total; }
+    private:
+        // Dense opcode id of every instruction
+        std::vector<int> m_opcodeIds;
+        // Opcode of every dense id
+        std::vector<uint32_t> m_opcodes;
+        int m_numOpcodes = 0;
+        int m_unknownId = 0;
+        std::vector<uint64_t> m_pairs;
+        std::vector<uint64_t> m_triples;
+        int m_previous = -1;
+        int m_beforePrevious = -1;
+        uint64_t m_total = 0;
+        uint64_t m_droppedTriples = 0;
+
+        /**
+         * Select the k largest counters
+         * @param counters
+         * @param length sequence length
+         * @param k
+         * @return sequences sorted by count
+         */
+        std::vector<Sequence> getTop(const std::vector<uint64_t> &counters, int length, int k) const;
+    };
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef WDB_TUI_STACK_PROFILE_H
+#define WDB_TUI_STACK_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <string>
+
+namespace wdb {
+    /**
+     * Track the value stack and call stack high-water marks
+     */
+    class StackProfile : public TraceListener {
+    public:
+        struct HighWater {
+            int value = 0;
+            std::string function;
+            uint32_t offset = 0;
+        };
+
+        /**
+         * Construct a stack profile
+         * @param callDepthLimit stop the run when the call depth exceeds it, 0 for no limit
+         */
+        explicit StackProfile(int callDepthLimit = 0) : m_callDepthLimit(callDepthLimit) {}
+
+        /**
+         * Clear high-water marks
+         */
+        void reset();
+
+        void onAfterInstruction(Tracer &tracer, int index, uint64_t time) override {
+            int height = tracer.getExecutor()->GetStackSize();
+            if(height > m_valueStack.value) {
+                record(tracer, m_valueStack, height, index);
+            }
+        }
+        void onCall(Tracer &tracer, int function, int callSite) override;
+
+        /**
+         * Get maximum value stack height
+         * @return high-water mark
+         */
+        const HighWater& getValueStack() const { return m_valueStack; }
+
+        /**
+         * Get maximum call depth
+         * @return high-water mark
+         */
+        const HighWater& getCallStack() const { return m_callStack; }
+
+        /**
+         * Check if the run was stopped by the call depth limit
+         * @return true if stopped
+         */
+        bool limitReached() const { return m_limitReached; }
+    private:
+        int m_callDepthLimit;
+        bool m_limitReached = false;
+        HighWater m_valueStack;
+        HighWater m_callStack;
+
+        /**
+         * Record a new high-water mark
+         * @param tracer
+         * @param highWater
+         * @param value
+         * @param index instruction index
+         */
+        static void record(Tracer &tracer, HighWater &highWater, int value, int index);
+    };
+}
+
+#endif
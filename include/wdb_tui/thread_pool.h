@@ -0,0 +1,69 @@
+#ifndef WDB_TUI_THREAD_POOL_H
+#define WDB_TUI_THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Fixed set of worker threads running queued tasks
+     */
+    class ThreadPool {
+    public:
+        /**
+         * Start workers
+         * @param threads number of workers, 0 for one per hardware thread
+         */
+        explicit ThreadPool(int threads = 0);
+
+        /**
+         * Finish queued tasks and stop workers
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Queue a task
+         * @param task
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * Block until all queued tasks finished
+         */
+        void wait();
+
+        /**
+         * Get number of workers
+         * @return count
+         */
+        int getThreadCount() const { return (int) m_workers.size(); }
+
+        /**
+         * Get number of hardware threads
+         * @return count, at least 1
+         */
+        static int getHardwareThreads();
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_taskReady;
+        std::condition_variable m_idle;
+        int m_active = 0;
+        bool m_stopping = false;
+
+        /**
+         * Worker loop
+         */
+        void work();
+    };
+}
+
+#endif
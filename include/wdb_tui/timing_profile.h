@@ -0,0 +1,94 @@
+#ifndef WDB_TUI_TIMING_PROFILE_H
+#define WDB_TUI_TIMING_PROFILE_H
+
+#include <wdb_tui/tracer.h>
+#include <wdb_tui/latency_histogram.h>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Collect time distributions per opcode and per function
+     */
+    class TimingProfile : public TraceListener {
+    public:
+        struct Entry {
+            std::string name;
+            uint64_t count = 0;
+            uint64_t totalTime = 0;
+            // Instructions executed, inclusive of callees for functions
+            uint64_t instructions = 0;
+            LatencyHistogram histogram;
+
+            uint64_t getAverageTime() const { return count == 0 ? 0 : totalTime / count; }
+        };
+
+        /**
+         * Construct an empty profile
+         */
+        TimingProfile();
+
+        /**
+         * Clear all entries
+         */
+        void reset();
+
+        /**
+         * Add results of another profile, functions are matched by name
+         * @param other
+         */
+        void merge(const TimingProfile &other);
+
+        void onStart(Tracer &tracer) override;
+        void onAfterInstruction(Tracer &tracer, int index, uint64_t time) override {
+            uint32_t opcode = index < 0 ? Tracer::getOpcodeCount() : tracer.getInstruction(index).opcode;
+            Entry &entry = m_opcodes[opcode];
+            entry.count++;
+            entry.instructions++;
+            entry.totalTime += time;
+            entry.histogram.record(time);
+        }
+        void onCall(Tracer &tracer, int function, int callSite) override {
+            m_callInstructions.push_back(tracer.getInstructionCount());
+        }
+        void onReturn(Tracer &tracer, int function, uint64_t time) override;
+
+        /**
+         * Get executed opcodes sorted
+         * @param sort
+         * @return entries
+         */
+        std::vector<const Entry*> getOpcodesSorted(wdb::WdbProfilerExecutor::Sort sort) const;
+
+        /**
+         * Get called functions sorted, function time is inclusive of callees
+         * @param sort
+         * @return entries
+         */
+        std::vector<const Entry*> getFunctionsSorted(wdb::WdbProfilerExecutor::Sort sort) const;
+    private:
+        // One entry per opcode, plus one for unknown instructions
+        std::vector<Entry> m_opcodes;
+        std::vector<Entry> m_functions;
+        // Instruction count at the entry of every active call
+        std::vector<uint64_t> m_callInstructions;
+
+        /**
+         * Add counters of an entry
+         * @param entry
+         * @param other
+         */
+        static void mergeEntry(Entry &entry, const Entry &other);
+
+        /**
+         * Sort non-empty entries
+         * @param entries
+         * @param sort
+         * @return sorted entries
+         */
+        static std::vector<const Entry*> sortEntries(const std::vector<Entry> &entries,
+                                                     wdb::WdbProfilerExecutor::Sort sort);
+    };
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef WDB_TUI_TIMINGS_H
+#define WDB_TUI_TIMINGS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    /**
+     * Process-wide record of startup phase durations.
+     * Phases are kept in the order they started, nested phases
+     * keep their depth. Meant for the main thread only, recording
+     * is stopped before worker threads or the interactive loop start.
+     */
+    class Timings {
+    public:
+        struct Phase {
+            std::string name;
+            int depth = 0;
+            // Duration in ns
+            uint64_t time = 0;
+        };
+
+        /**
+         * Get the process-wide timings
+         * @return timings
+         */
+        static Timings& get();
+
+        // Index of phases started after recording stopped
+        static const size_t IGNORED = (size_t) -1;
+
+        /**
+         * Start a phase
+         * @param name
+         * @return phase index, IGNORED if recording stopped
+         */
+        size_t begin(const std::string &name);
+
+        /**
+         * End a phase
+         * @param index phase index
+         * @param time duration in ns
+         */
+        void end(size_t index, uint64_t time);
+
+        /**
+         * Stop recording new phases, phases already started still end
+         */
+        void stop() { m_stopped = true; }
+
+        /**
+         * Record new phases again
+         */
+        void resume() { m_stopped = false; }
+
+        /**
+         * Print phases as an indented tree
+         * @param out
+         */
+        void print(std::ostream &out) const;
+
+        /**
+         * Get a one-line summary of the top-level phases
+         * @return summary
+         */
+        std::string getSummary() const;
+
+        const std::vector<Phase>& getPhases() const { return m_phases; }
+    private:
+        std::vector<Phase> m_phases;
+        int m_depth = 0;
+        bool m_stopped = false;
+    };
+
+    /**
+     * Record the lifetime of a scope as a phase
+     */
+    class ScopedTimer {
+    public:
+        /**
+         * Start timing
+         * @param name phase name
+         */
+        explicit ScopedTimer(const std::string &name) : m_index(Timings::get().begin(name)),
+                                                        m_start(std::chrono::steady_clock::now()) {}
+
+        /**
+         * Stop timing
+         */
+        ~ScopedTimer() {
+            Timings::get().end(m_index, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - m_start).count());
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    private:
+        size_t m_index;
+        std::chrono::steady_clock::time_point m_start;
+    };
+}
+
+#endif
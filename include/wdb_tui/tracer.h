@@ -0,0 +1,277 @@
+#ifndef WDB_TUI_TRACER_H
+#define WDB_TUI_TRACER_H
+
+#include <wdb_tui/module_index.h>
+#include <wdb/wdb_wabt.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wdb {
+    class Tracer;
+
+    /**
+     * Receive execution events from a tracer
+     */
+    class TraceListener {
+    public:
+        virtual ~TraceListener() {}
+
+        /**
+         * Called once before the first traced instruction
+         * @param tracer
+         */
+        virtual void onStart(Tracer &tracer) {}
+
+        /**
+         * Called before an instruction is executed
+         * @param tracer
+         * @param index instruction index, -1 if unknown
+         */
+        virtual void onBeforeInstruction(Tracer &tracer, int index) {}
+
+        /**
+         * Called after an instruction was executed
+         * @param tracer
+         * @param index instruction index, -1 if unknown
+         * @param time in ns
+         */
+        virtual void onAfterInstruction(Tracer &tracer, int index, uint64_t time) {}
+
+        /**
+         * Called when a function is entered
+         * @param tracer
+         * @param function function index
+         * @param callSite instruction index of the call, -1 for the main function
+         */
+        virtual void onCall(Tracer &tracer, int function, int callSite) {}
+
+        /**
+         * Called when a function returns
+         * @param tracer
+         * @param function function index
+         * @param time inclusive time in ns
+         */
+        virtual void onReturn(Tracer &tracer, int function, uint64_t time) {}
+
+        /**
+         * Called once after the main function returned
+         * @param tracer
+         */
+        virtual void onFinish(Tracer &tracer) {}
+    };
+
+    /**
+     * Step a debugger executor one instruction at a time
+     * and report every instruction to the registered listeners
+     */
+    class Tracer {
+    public:
+        enum Kind : uint8_t {
+            OTHER = 0,
+            LOAD,
+            STORE,
+            BRANCH,
+            CALL,
+            CALL_HOST,
+            RETURN,
+            MEMORY_GROW,
+            UNREACHABLE
+        };
+
+        struct Instruction {
+            uint32_t offset = 0;
+            uint32_t opcode = wabt::Opcode::Invalid;
+            Kind kind = OTHER;
+            // Bytes accessed by a load or a store
+            uint8_t accessSize = 0;
+            // Memory index of a load, store or memory grow
+            uint32_t memory = 0;
+            // Static offset of a load or a store, target of a branch or a direct call, 0 for call_indirect
+            uint32_t immediate = 0;
+            // Every target of a branch, several for br_table
+            std::vector<uint32_t> targets;
+            int function = -1;
+            // Basic block containing the instruction
+            int block = -1;
+            bool blockStart = false;
+            std::string text;
+        };
+
+        struct Function {
+            std::string name;
+            // Function index in the module, imports counted, -1 if unknown
+            int index = -1;
+            uint32_t offset = 0;
+            int firstInstruction = 0;
+            int endInstruction = 0;
+        };
+
+        /**
+         * Construct a tracer over an executor
+         * @param executor
+         * @param moduleIndex index with the module binary read, lists functions that are not exported nor called
+         * directly and names them, null to find functions from exports and direct calls only
+         */
+        explicit Tracer(wdb::WdbDebuggerExecutor *executor, wdb::ModuleIndex *moduleIndex = nullptr);
+
+        /**
+         * Add a listener, listeners are not owned by the tracer
+         * @param listener
+         */
+        void addListener(TraceListener *listener) { m_listeners.push_back(listener); }
+
+        /**
+         * Remove a listener
+         * @param listener
+         */
+        void removeListener(TraceListener *listener) {
+            m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), listener), m_listeners.end());
+        }
+
+        /**
+         * Time every instruction, on by default. Untimed instructions report 0 ns, which spares two clock
+         * reads per instruction for listeners that only count
+         * @param timed
+         */
+        void setTimed(bool timed) { m_timed = timed; }
+
+        /**
+         * Execute next instruction
+         * @return result
+         */
+        wabt::Result step();
+
+        /**
+         * Execute instructions until the main function returns or a breakpoint is reached
+         * @return result
+         */
+        wabt::Result run();
+
+        /**
+         * Stop run() after the current instruction, run() then fails
+         */
+        void stop() { m_stopped = true; }
+
+        /**
+         * Stop run() before executing an instruction
+         * @param index instruction index
+         * @param enabled
+         */
+        void setBreakpoint(int index, bool enabled);
+
+        /**
+         * Get index of the instruction at an offset
+         * @param offset
+         * @return index, -1 if not found
+         */
+        int getInstructionIndex(uint32_t offset);
+
+        /**
+         * Get effective address of a load or a store that is about to execute
+         * @param instruction
+         * @param address
+         * @return true if the address was read from the stack
+         */
+        bool getAccessAddress(const Instruction &instruction, uint64_t &address) const {
+            // Address is on top of the stack for loads, below the value for stores
+            int slot = m_executor->GetStackSize() - (instruction.kind == LOAD ? 1 : 2);
+            if(slot < 0) {
+                return false;
+            }
+            address = (uint64_t) m_executor->GetStackAt(slot).i32 + instruction.immediate;
+            return true;
+        }
+
+        /**
+         * Get the name of an opcode
+         * @param opcode
+         * @return name
+         */
+        static std::string getOpcodeName(uint32_t opcode);
+
+        /**
+         * Get number of opcodes, which is also the id of the unknown opcode
+         * @return count
+         */
+        static uint32_t getOpcodeCount() { return wabt::Opcode::Invalid; }
+
+        /**
+         * Get current function
+         * @return function index, -1 if no function is running
+         */
+        int getCurrentFunction() const { return m_callStack.empty() ? -1 : m_callStack.back().function; }
+
+        /**
+         * Get call stack depth
+         * @return depth
+         */
+        int getCallDepth() const { return (int) m_callStack.size(); }
+
+        wdb::WdbDebuggerExecutor* getExecutor() const { return m_executor; }
+        const std::vector<Instruction>& getInstructions() const { return m_instructions; }
+        const Instruction& getInstruction(int index) const { return m_instructions[index]; }
+        const std::vector<Function>& getFunctions() const { return m_functions; }
+        const Function& getFunction(int index) const { return m_functions[index]; }
+        int getBlockCount() const { return m_blockCount; }
+        uint64_t getInstructionCount() const { return m_instructionCount; }
+        uint64_t getElapsedTime() const { return m_elapsedTime; }
+    private:
+        struct Frame {
+            int function;
+            uint64_t startTime;
+        };
+
+        wdb::WdbDebuggerExecutor *m_executor = nullptr;
+        std::vector<TraceListener*> m_listeners;
+        std::vector<Instruction> m_instructions;
+        std::vector<Function> m_functions;
+        std::vector<Frame> m_callStack;
+        std::vector<bool> m_breakpoints;
+        int m_blockCount = 0;
+        int m_lastIndex = -1;
+        bool m_started = false;
+        bool m_finished = false;
+        bool m_stopped = false;
+        bool m_timed = true;
+        uint64_t m_instructionCount = 0;
+        uint64_t m_elapsedTime = 0;
+
+        /**
+         * Decode disassembled instruction
+         * @param instruction
+         * @return decoded instruction
+         */
+        static Instruction decode(const wdb::WdbDebuggerExecutor::Instruction &instruction);
+
+        /**
+         * Split instructions into functions
+         * @param moduleIndex
+         */
+        void buildFunctions(wdb::ModuleIndex *moduleIndex);
+
+        /**
+         * Split instructions into basic blocks
+         */
+        void buildBlocks();
+
+        /**
+         * Start tracing
+         */
+        void start();
+
+        /**
+         * Push function starting at the current pc, unknown if the pc is not a function entry
+         * @param callSite
+         */
+        void enterFunction(int callSite);
+
+        /**
+         * Pop current function
+         */
+        void leaveFunction();
+    };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define WDB_TUI_WASM_DISPLAY_H
 
 #include <wdb_tui/display.h>
+#include <wdb_tui/module_cache.h>
 #include <wdb/wdb_wabt.h>
 #include <string>
 #include <vector>
@@ -11,6 +12,9 @@ namespace wdb {
     private:
         wdb::WdbCodeGen* m_codeGen = nullptr;
         std::vector<std::string> m_wastCode;
+        bool m_wastGenerated = false;
+        wdb::ModuleCache *m_cache = nullptr;
+        std::string m_cacheKey;
         int m_vscroll = 0;
         int m_lineHighlight = 0;
         int m_codeNumLines = 0;
@@ -20,6 +24,11 @@ namespace wdb {
          * Update screen
          */
         void update();
+
+        /**
+         * Generate wast code once, or read it from the cache
+         */
+        void generateWast();
     public:
         WastDisplay(wdb::WdbWabt* wdbWabt);
 
@@ -29,6 +38,13 @@ namespace wdb {
          */
         void setWast(std::string str);
 
+        /**
+         * Reuse wast code generated by previous runs
+         * @param cache
+         * @param key module content key
+         */
+        void setCache(wdb::ModuleCache *cache, const std::string &key);
+
         /**
          * Listen for user input
          */
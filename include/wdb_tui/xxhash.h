@@ -0,0 +1,18 @@
+#ifndef WDB_TUI_XXHASH_H
+#define WDB_TUI_XXHASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wdb {
+    /**
+     * Compute the XXH64 hash of a buffer
+     * @param data
+     * @param size
+     * @param seed
+     * @return hash
+     */
+    uint64_t XxHash64(const void *data, size_t size, uint64_t seed = 0);
+}
+
+#endif
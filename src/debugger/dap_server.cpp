@@ -0,0 +1,410 @@
+#include <wdb_tui/dap_server.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace wdb {
+    const uint64_t DapServer::MAX_MEMORY_READ;
+    const uint64_t DapServer::MAX_MESSAGE_LENGTH;
+
+    DapServer::DapServer(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, const std::string &sourceName,
+                         std::istream &in, std::ostream &out) : m_sourceName(sourceName), m_in(in), m_out(out) {
+        m_session.reset(new DebugSession(wdbWabt, options, [this](const std::string &text) {
+            if(m_capture) {
+                m_captured += text;
+            } else {
+                Json body = Json::object();
+                body["category"] = "stdout";
+                body["output"] = text;
+                event("output", body);
+            }
+        }, [this](const std::string &text) {
+            if(m_capture) {
+                m_captured += text + "\n";
+            } else {
+                Json body = Json::object();
+                body["category"] = "console";
+                body["output"] = text + "\n";
+                event("output", body);
+            }
+        }));
+    }
+
+    bool DapServer::serve(std::string &error) {
+        Json message;
+        error.clear();
+        while(readMessage(message, error)) {
+            // Ignore malformed messages, responses and events
+            if(!message.isObject() || message.get("type").asString() != "request") {
+                continue;
+            }
+            if(!handleRequest(message)) {
+                return true;
+            }
+        }
+        if(error.empty()) {
+            error = "Client closed the input";
+        }
+        return false;
+    }
+
+    bool DapServer::readMessage(Json &message, std::string &error) {
+        std::string line;
+        uint64_t length = 0;
+        bool hasLength = false;
+        while(std::getline(m_in, line)) {
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if(line.empty()) {
+                if(hasLength) {
+                    break;
+                }
+                continue;
+            }
+            std::string header = "Content-Length:";
+            if(line.compare(0, header.size(), header) == 0) {
+                char *end = nullptr;
+                length = std::strtoull(line.c_str() + header.size(), &end, 10);
+                hasLength = *end == '\0';
+            }
+        }
+        if(!hasLength || !m_in) {
+            return false;
+        }
+        // Never allocate what the client claims before reading it
+        if(length > MAX_MESSAGE_LENGTH) {
+            error = "Message of " + std::to_string(length) + " bytes exceeds the limit of "
+                    + std::to_string(MAX_MESSAGE_LENGTH);
+            return false;
+        }
+        std::string body(length, '\0');
+        if(!m_in.read(&body[0], (std::streamsize) length)) {
+            return false;
+        }
+        if(!Json::parse(body, message)) {
+            message = Json();
+        }
+        return true;
+    }
+
+    void DapServer::send(Json message) {
+        message["seq"] = m_sequence++;
+        std::string text = message.dump();
+        m_out << "Content-Length: " << text.size() << "\r\n\r\n" << text;
+        m_out.flush();
+    }
+
+    void DapServer::respond(const Json &request, const Json &body, const std::string &error) {
+        Json response = Json::object();
+        response["type"] = "response";
+        response["request_seq"] = request.get("seq").asInt();
+        response["command"] = request.get("command").asString();
+        response["success"] = error.empty();
+        if(!error.empty()) {
+            response["message"] = error;
+        }
+        response["body"] = body;
+        send(response);
+    }
+
+    void DapServer::event(const std::string &name, const Json &body) {
+        Json message = Json::object();
+        message["type"] = "event";
+        message["event"] = name;
+        message["body"] = body;
+        send(message);
+    }
+
+    bool DapServer::handleRequest(const Json &request) {
+        const std::string &command = request.get("command").asString();
+        const Json &arguments = request.get("arguments");
+        auto executor = m_session->getExecutor();
+        Json body = Json::object();
+        if(command == "initialize") {
+            body["supportsConfigurationDoneRequest"] = true;
+            body["supportsReadMemoryRequest"] = true;
+            body["supportsTerminateRequest"] = true;
+            respond(request, body);
+            event("initialized", Json::object());
+        } else if(command == "launch") {
+            if(arguments.has("function")) {
+                m_mainFunction = arguments.get("function").asString();
+            }
+            if(!executor) {
+                respond(request, body, "Error creating executor");
+            } else if(m_mainFunction.empty()) {
+                respond(request, body, "No function to debug, set 'function' in the launch arguments");
+            } else {
+                m_capture = true;
+                m_captured.clear();
+                m_session->execute("main " + m_mainFunction);
+                m_capture = false;
+                if(!executor->MainFunctionIsSet()) {
+                    m_captured.erase(m_captured.find_last_not_of('\n') + 1);
+                    respond(request, body, m_captured);
+                } else {
+                    m_launched = true;
+                    m_stopOnEntry = arguments.get("stopOnEntry").asBool();
+                    respond(request, body);
+                    start();
+                }
+            }
+        } else if(command == "setBreakpoints") {
+            // Lines of any source are instruction lines
+            if(executor) {
+                std::set<int> previous = m_session->getBreakpoints();
+                for(int line : previous) {
+                    m_session->removeBreakpoint(line);
+                }
+            }
+            Json breakpoints = Json::array();
+            for(auto &requested : arguments.get("breakpoints").getArray()) {
+                int line = (int) requested.get("line").asInt();
+                bool verified = executor && m_session->addBreakpoint(line);
+                Json breakpoint = Json::object();
+                breakpoint["verified"] = verified;
+                breakpoint["line"] = line;
+                if(!verified) {
+                    breakpoint["message"] = "No instruction at this line";
+                }
+                breakpoints.push(breakpoint);
+            }
+            body["breakpoints"] = breakpoints;
+            respond(request, body);
+        } else if(command == "configurationDone") {
+            m_configured = true;
+            respond(request, body);
+            start();
+        } else if(command == "threads") {
+            Json thread = Json::object();
+            thread["id"] = 1;
+            thread["name"] = "main";
+            body["threads"] = Json::array();
+            body["threads"].push(thread);
+            respond(request, body);
+        } else if(command == "stackTrace") {
+            body["stackFrames"] = Json::array();
+            if(executor && m_launched && !m_terminated) {
+                std::stringstream pc;
+                pc << "0x" << std::hex << executor->GetPcOffset();
+                Json frame = Json::object();
+                frame["id"] = 1;
+                frame["name"] = m_mainFunction;
+                frame["source"] = getSource();
+                frame["line"] = m_session->getCurrentLine();
+                frame["column"] = 1;
+                frame["instructionPointerReference"] = pc.str();
+                body["stackFrames"].push(frame);
+            }
+            body["totalFrames"] = (uint64_t) body["stackFrames"].size();
+            respond(request, body);
+        } else if(command == "scopes") {
+            Json stack = Json::object();
+            stack["name"] = "Stack";
+            stack["presentationHint"] = "locals";
+            stack["variablesReference"] = (int) STACK_REFERENCE;
+            stack["indexedVariables"] = executor ? executor->GetStackSize() : 0;
+            stack["expensive"] = false;
+            Json memories = Json::object();
+            memories["name"] = "Memories";
+            memories["variablesReference"] = (int) MEMORIES_REFERENCE;
+            memories["indexedVariables"] = executor ? executor->GetMemoriesCount() : 0;
+            memories["expensive"] = false;
+            body["scopes"] = Json::array();
+            body["scopes"].push(stack);
+            body["scopes"].push(memories);
+            respond(request, body);
+        } else if(command == "variables") {
+            // Editors page large scopes with start and count
+            body["variables"] = getVariables(arguments.get("variablesReference").asUint(),
+                                             arguments.get("start").asUint(), arguments.get("count").asUint());
+            respond(request, body);
+        } else if(command == "readMemory") {
+            const std::string &reference = arguments.get("memoryReference").asString();
+            char *end = nullptr;
+            long memory = reference.compare(0, 6, "memory") == 0 ? std::strtol(reference.c_str() + 6, &end, 10) : -1;
+            if(!executor || !end || *end != '\0' || memory < 0 || memory >= executor->GetMemoriesCount()) {
+                respond(request, body, "Invalid memory reference '" + reference + "'");
+                return true;
+            }
+            int64_t offset = arguments.get("offset").asInt();
+            uint64_t count = arguments.get("count").asUint();
+            // Bytes before the memory are skipped, the reply starts at its address
+            if(offset < 0) {
+                count = count > (uint64_t) -offset ? count - (uint64_t) -offset : 0;
+                offset = 0;
+            }
+            count = std::min(count, MAX_MEMORY_READ);
+            uint64_t size = (uint64_t) executor->GetMemorySize((int) memory);
+            uint64_t start = std::min((uint64_t) offset, size);
+            uint64_t readable = std::min(count, size - start);
+            // Copy the span once and encode it in one pass
+            std::vector<uint8_t> bytes((size_t) readable);
+            for(uint64_t i=0; i < readable; i++) {
+                bytes[i] = (uint8_t) executor->GetMemoryAt((int) memory, (int) (start + i));
+            }
+            std::stringstream address;
+            address << "0x" << std::hex << start;
+            body["address"] = address.str();
+            body["data"] = toBase64(bytes.data(), bytes.size());
+            body["unreadableBytes"] = count - readable;
+            respond(request, body);
+        } else if(command == "next" || command == "stepIn" || command == "continue") {
+            if(!executor || !m_launched || m_terminated) {
+                respond(request, body, "The program is not running");
+                return true;
+            }
+            if(command == "continue") {
+                body["allThreadsContinued"] = true;
+            }
+            respond(request, body);
+            if(command == "continue") {
+                resume("continue", "breakpoint");
+            } else {
+                resume("step", "step");
+            }
+        } else if(command == "pause") {
+            // Execution is synchronous, the program is already stopped
+            respond(request, body);
+            reportStop("pause");
+        } else if(command == "evaluate") {
+            // Expressions are debugger commands
+            uint32_t pc = executor ? executor->GetPcOffset() : 0;
+            m_capture = true;
+            m_captured.clear();
+            auto status = m_session->execute(arguments.get("expression").asString());
+            m_capture = false;
+            m_captured.erase(m_captured.find_last_not_of('\n') + 1);
+            if(status == CommandRegistry::NOT_FOUND || status == CommandRegistry::INVALID_ARGUMENTS) {
+                respond(request, body, m_captured);
+            } else {
+                body["result"] = m_captured;
+                body["variablesReference"] = 0;
+                respond(request, body);
+                // Keep the editor in sync after step, continue or restart
+                executor = m_session->getExecutor();
+                if(m_launched && !m_terminated && executor && executor->GetPcOffset() != pc) {
+                    reportStop("step");
+                }
+            }
+        } else if(command == "source") {
+            std::string content;
+            for(auto &instruction : m_session->getInstructions()) {
+                content += instruction.str + "\n";
+            }
+            body["content"] = content;
+            respond(request, body);
+        } else if(command == "terminate") {
+            respond(request, body);
+            m_terminated = true;
+            event("terminated", Json::object());
+        } else if(command == "disconnect") {
+            respond(request, body);
+            return false;
+        } else {
+            respond(request, body, "Unsupported request '" + command + "'");
+        }
+        return true;
+    }
+
+    void DapServer::start() {
+        if(!m_launched || !m_configured) {
+            return;
+        }
+        if(m_stopOnEntry) {
+            reportStop("entry");
+        } else {
+            resume("continue", "breakpoint");
+        }
+    }
+
+    void DapServer::resume(const std::string &command, const std::string &reason) {
+        m_session->execute(command);
+        // Continuing stops early only on breakpoints and traps
+        int line = m_session->getCurrentLine();
+        bool breakpoint = m_session->getBreakpoints().count(line) > 0;
+        reportStop(command == "continue" && !breakpoint ? "exception" : reason);
+    }
+
+    void DapServer::reportStop(const std::string &reason) {
+        auto executor = m_session->getExecutor();
+        if(executor && executor->MainFunctionIsSet() && executor->MainFunctionHasReturned()) {
+            if(!m_terminated) {
+                m_terminated = true;
+                Json exited = Json::object();
+                exited["exitCode"] = 0;
+                event("exited", exited);
+                event("terminated", Json::object());
+            }
+            return;
+        }
+        Json body = Json::object();
+        body["reason"] = reason;
+        body["threadId"] = 1;
+        body["allThreadsStopped"] = true;
+        event("stopped", body);
+    }
+
+    Json DapServer::getSource() const {
+        Json source = Json::object();
+        source["name"] = m_sourceName;
+        source["sourceReference"] = 1;
+        return source;
+    }
+
+    Json DapServer::getVariables(uint64_t reference, uint64_t start, uint64_t count) const {
+        Json variables = Json::array();
+        auto executor = m_session->getExecutor();
+        if(!executor || (reference != STACK_REFERENCE && reference != MEMORIES_REFERENCE)) {
+            return variables;
+        }
+        uint64_t size = (uint64_t) (reference == STACK_REFERENCE ? executor->GetStackSize()
+                                                                   : executor->GetMemoriesCount());
+        if(start >= size) {
+            return variables;
+        }
+        uint64_t end = count == 0 ? size : start + std::min(count, size - start);
+        // Only the requested page is formatted
+        for(uint64_t i=start; i < end; i++) {
+            Json variable = Json::object();
+            std::stringstream value;
+            if(reference == STACK_REFERENCE) {
+                auto entry = executor->GetStackAt(executor->GetStackSize() - (int) i - 1);
+                value << "0x" << std::setfill('0') << std::setw(16) << std::hex << entry.i64;
+                variable["name"] = "stack[" + std::to_string(i) + "]";
+                variable["evaluateName"] = "print stack[" + std::to_string(i) + "].i64";
+            } else {
+                value << executor->GetMemorySize((int) i) << " bytes";
+                variable["name"] = "memory" + std::to_string(i);
+                variable["memoryReference"] = "memory" + std::to_string(i);
+            }
+            variable["value"] = value.str();
+            variable["variablesReference"] = 0;
+            variables.push(variable);
+        }
+        return variables;
+    }
+
+    std::string DapServer::toBase64(const uint8_t *data, size_t size) {
+        static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string text;
+        text.reserve((size + 2) / 3 * 4);
+        for(size_t i=0; i < size; i += 3) {
+            uint32_t group = (uint32_t) data[i] << 16;
+            if(i + 1 < size) {
+                group |= (uint32_t) data[i + 1] << 8;
+            }
+            if(i + 2 < size) {
+                group |= data[i + 2];
+            }
+            text += digits[(group >> 18) & 0x3f];
+            text += digits[(group >> 12) & 0x3f];
+            text += i + 1 < size ? digits[(group >> 6) & 0x3f] : '=';
+            text += i + 2 < size ? digits[group & 0x3f] : '=';
+        }
+        return text;
+    }
+}
@@ -0,0 +1,223 @@
+#include <wdb_tui/debug_session.h>
+#include <wdb_tui/timings.h>
+#include <wabt/src/cast.h>
+#include <sstream>
+
+namespace wdb {
+    DebugSession::DebugSession(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, Handler outputHandler,
+                               Handler messageHandler, wdb::ModuleIndex *moduleIndex) :
+            m_wdbWabt(wdbWabt), m_moduleIndex(moduleIndex ? moduleIndex : &m_ownModuleIndex),
+            m_outputHandler(outputHandler), m_messageHandler(messageHandler) {
+        // Configure executor options
+        m_executorOptions.preSetup = options.preSetup;
+        m_executorOptions.outputStreamHandler = [this](std::string text) {
+            m_outputHandler(text);
+        };
+        m_executorOptions.errorStreamHandler = [this](std::string text) {
+            m_messageHandler("[ERR] " + text);
+        };
+        registerCommands();
+        // Create a default executor
+        restart();
+    }
+
+    bool DebugSession::restart() {
+        {
+            // Only recorded while starting up
+            ScopedTimer timer("instantiate");
+            m_executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_executorOptions);
+        }
+        m_tracer.reset();
+        m_blockProfile.reset();
+        m_instructions.clear();
+        if(!m_executor) {
+            return false;
+        }
+        // Trace execution, counting basic blocks only if requested
+        ScopedTimer timer("disassemble");
+        m_tracer.reset(new wdb::Tracer(m_executor, m_moduleIndex));
+        // Stepping does not report instruction times, skip reading the clock
+        m_tracer->setTimed(false);
+        if(m_traceBlocks) {
+            m_tracer->addListener(&m_blockProfile);
+        }
+        // Exports are the same after a restart, index them once
+        m_moduleIndex->build(m_executor);
+        // Complete function names in commands
+        m_commands.setNames(m_moduleIndex->getNames());
+        // Restore breakpoints
+        m_instructions = m_executor->DisassembleModule(m_executor->GetMainModule());
+        std::set<int> breakpoints = m_breakLine;
+        for(int line : breakpoints) {
+            addBreakpoint(line);
+        }
+        return true;
+    }
+
+    void DebugSession::setTraceBlocks(bool enabled) {
+        if(m_tracer && enabled != m_traceBlocks) {
+            if(enabled) {
+                m_tracer->addListener(&m_blockProfile);
+            } else {
+                m_tracer->removeListener(&m_blockProfile);
+            }
+        }
+        m_traceBlocks = enabled;
+    }
+
+    CommandRegistry::Status DebugSession::execute(const std::string &line) {
+        std::string error;
+        auto status = m_commands.execute(line, error);
+        if(status != CommandRegistry::EXECUTED && status != CommandRegistry::EMPTY) {
+            m_messageHandler(error);
+        }
+        return status;
+    }
+
+    bool DebugSession::addBreakpoint(int line) {
+        if(line < 1 || line > m_instructions.size()) {
+            return false;
+        }
+        m_executor->AddBreakpoint(m_instructions[line-1].istream_start);
+        m_tracer->setBreakpoint(line-1, true);
+        m_breakLine.insert(line);
+        return true;
+    }
+
+    bool DebugSession::removeBreakpoint(int line) {
+        if(line < 1 || line > m_instructions.size()) {
+            return false;
+        }
+        m_executor->RemoveBreakpoint(m_instructions[line-1].istream_start);
+        m_tracer->setBreakpoint(line-1, false);
+        m_breakLine.erase(line);
+        return true;
+    }
+
+    int DebugSession::getCurrentLine() const {
+        if(!m_executor) {
+            return 0;
+        }
+        return getLine(m_executor->GetPcOffset());
+    }
+
+    int DebugSession::getLine(uint32_t offset) const {
+        for(size_t i=0; i < m_instructions.size(); i++) {
+            if(m_instructions[i].istream_start == offset) {
+                return (int) i + 1;
+            }
+        }
+        return 0;
+    }
+
+    void DebugSession::registerCommands() {
+        // Commands using the executor fail when it could not be created
+        auto withExecutor = [this](const CommandRegistry::Handler &handler) -> CommandRegistry::Handler {
+            return [this, handler](const Arguments &arguments) {
+                if(m_executor) {
+                    handler(arguments);
+                } else {
+                    m_messageHandler("No executor, type 'restart' to create one");
+                }
+            };
+        };
+        m_commands.add({"help", {}, {}, "", "Display this message", [this](const Arguments &arguments) {
+            m_messageHandler("Commands:");
+            for(auto &line : m_commands.getHelp()) {
+                m_messageHandler(line);
+            }
+        }});
+        m_commands.add({"restart", {}, {}, "", "Debug function", [this](const Arguments &arguments) {
+            if(!restart()) {
+                m_messageHandler("Error creating an executor");
+            }
+        }});
+        m_commands.add({"main", {}, {CommandRegistry::NAME}, "<func-name>", "Set main function",
+                        withExecutor([this](const Arguments &arguments) {
+            // Search for function
+            const std::string &funcName = arguments[0].text;
+            auto func = m_moduleIndex->getFunction(m_executor, funcName);
+            if(func) {
+                // Set the main function
+                if(m_executor->SetMainFunction(func) == wabt::Result::Ok) {
+                    m_messageHandler("Program main function set to '" + funcName +"'");
+                } else {
+                    m_messageHandler("Failed to set '" + funcName + "' main function");
+                }
+            } else {
+                m_messageHandler("Function '" + funcName + "' was not found");
+            }
+        })});
+        m_commands.add({"step", {"s"}, {}, "", "Step into execution",
+                        withExecutor([this](const Arguments &arguments) {
+            if(m_tracer->step() != wabt::Result::Ok) {
+                m_messageHandler("Cannot execute next instruction");
+            }
+        })});
+        m_commands.add({"continue", {"c"}, {}, "", "Continue execution",
+                        withExecutor([this](const Arguments &arguments) {
+            // The executor stops at breakpoints itself, step only to count blocks
+            if((m_traceBlocks ? m_tracer->run() : m_executor->Execute()) != wabt::Result::Ok) {
+                m_messageHandler("Cannot continue executing instructions");
+            }
+        })});
+        m_commands.add({"break", {"b"}, {CommandRegistry::LINE}, "<pc>", "Add breakpoint at given line",
+                        [this](const Arguments &arguments) {
+            if(!addBreakpoint((int) arguments[0].number)) {
+                m_messageHandler("Breakpoint line number is out of bound");
+            }
+        }});
+        m_commands.add({"breakrm", {}, {CommandRegistry::LINE}, "<pc>", "Remove breakpoint at given line",
+                        [this](const Arguments &arguments) {
+            if(!removeBreakpoint((int) arguments[0].number)) {
+                m_messageHandler("Breakpoint line number is out of bound");
+            }
+        }});
+        m_commands.add({"breakls", {}, {}, "", "List all breakpoint lines", [this](const Arguments &arguments) {
+            std::stringstream ss;
+            ss << "[";
+            for(auto i = m_breakLine.begin(); i != m_breakLine.end(); i++) {
+                if(i != m_breakLine.begin()) {
+                    ss << ",";
+                }
+                ss << *i;
+            }
+            ss << "]";
+            m_messageHandler(ss.str());
+        }});
+        m_commands.add({"print", {"p"}, {CommandRegistry::LOCATION}, "<location>",
+                        "Print stack[top=0].type with type i32, i64, f32, f64 or v128",
+                        withExecutor([this](const Arguments &arguments) {
+            auto &location = arguments[0].location;
+            // For stack variable
+            if(location.space == "stack") {
+                // Check for index out of bound
+                if(location.index >= m_executor->GetStackSize()) {
+                    m_messageHandler("Index out of stack bound");
+                } else {
+                    // Prepare a typed value for easy printing
+                    wabt::interp::TypedValue valType;
+                    // Fetch stack entry
+                    auto stackEntry = m_executor->GetStackAt(m_executor->GetStackSize() - location.index - 1);
+                    // Check the type
+                    if(location.type == "i32") {
+                        valType.type = wabt::Type::I32;
+                    } else if(location.type == "i64") {
+                        valType.type = wabt::Type::I64;
+                    } else if(location.type == "f32") {
+                        valType.type = wabt::Type::F32;
+                    } else if(location.type == "f64") {
+                        valType.type = wabt::Type::F64;
+                    } else if(location.type == "v128") {
+                        valType.type = wabt::Type::V128;
+                    }
+                    valType.value = stackEntry;
+                    m_messageHandler(wabt::interp::TypedValueToString(valType));
+                }
+            } else if(location.space == "memo") {
+                // TODO
+                m_messageHandler("No yet implemented");
+            }
+        })});
+    }
+}
@@ -0,0 +1,545 @@
+#include <wdb_tui/gdb_server.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace wdb {
+    const size_t GdbServer::PACKET_SIZE;
+    const int GdbServer::STACK_REGISTERS;
+
+    namespace {
+        // Register numbers of the pc and the stack size, stack values follow
+        const int REGISTER_PC = 0;
+        const int REGISTER_SP = 1;
+        const int REGISTER_COUNT = 2 + GdbServer::STACK_REGISTERS;
+
+        /**
+         * Parse a hex number
+         * @param text
+         * @param value
+         * @return true if the whole text was parsed
+         */
+        bool parseHex(const std::string &text, uint64_t &value) {
+            if(text.empty() || text.size() > 16) {
+                return false;
+            }
+            char *end = nullptr;
+            value = std::strtoull(text.c_str(), &end, 16);
+            return *end == '\0';
+        }
+
+        /**
+         * Parse "<addr>,<length>"
+         * @param text
+         * @param address
+         * @param length
+         * @return true if parsed
+         */
+        bool parseRange(const std::string &text, uint64_t &address, uint64_t &length) {
+            size_t comma = text.find(',');
+            return comma != std::string::npos && parseHex(text.substr(0, comma), address)
+                   && parseHex(text.substr(comma + 1), length);
+        }
+
+        /**
+         * Decode hex text
+         * @param hex
+         * @return text
+         */
+        std::string fromHex(const std::string &hex) {
+            std::string text;
+            for(size_t i=0; i + 1 < hex.size(); i += 2) {
+                text += (char) std::strtol(hex.substr(i, 2).c_str(), nullptr, 16);
+            }
+            return text;
+        }
+    }
+
+    GdbServer::GdbServer(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options) {
+        m_session.reset(new DebugSession(wdbWabt, options, [this](const std::string &text) {
+            m_console += text;
+        }, [this](const std::string &text) {
+            m_console += text + "\n";
+        }));
+    }
+
+    GdbServer::~GdbServer() {
+        if(m_socket >= 0) {
+            close(m_socket);
+        }
+        if(m_listenSocket >= 0) {
+            close(m_listenSocket);
+        }
+        if(!m_unixPath.empty()) {
+            unlink(m_unixPath.c_str());
+        }
+    }
+
+    bool GdbServer::listen(const std::string &address, std::string &error) {
+        if(address.compare(0, 5, "unix:") == 0) {
+            std::string path = address.substr(5);
+            sockaddr_un socketAddress;
+            std::memset(&socketAddress, 0, sizeof(socketAddress));
+            if(path.empty() || path.size() >= sizeof(socketAddress.sun_path)) {
+                error = "Invalid socket path: " + path;
+                return false;
+            }
+            // Replace a stale socket, but never another kind of file
+            struct stat status;
+            if(stat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+                unlink(path.c_str());
+            }
+            socketAddress.sun_family = AF_UNIX;
+            std::strncpy(socketAddress.sun_path, path.c_str(), sizeof(socketAddress.sun_path) - 1);
+            m_listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+            if(m_listenSocket < 0 || bind(m_listenSocket, (sockaddr*) &socketAddress, sizeof(socketAddress)) != 0) {
+                error = "Cannot bind " + path + ": " + std::strerror(errno);
+                return false;
+            }
+            m_unixPath = path;
+        } else {
+            // Only loopback, the protocol has no authentication
+            size_t colon = address.rfind(':');
+            std::string host = colon == std::string::npos ? "localhost" : address.substr(0, colon);
+            std::string port = colon == std::string::npos ? address : address.substr(colon + 1);
+            char *end = nullptr;
+            uint64_t portNumber = std::strtoull(port.c_str(), &end, 10);
+            if(port.empty() || *end != '\0' || portNumber == 0 || portNumber > 65535) {
+                error = "Invalid port: " + port;
+                return false;
+            }
+            if(host != "localhost" && host != "127.0.0.1" && !host.empty()) {
+                error = "Only localhost addresses are allowed: " + host;
+                return false;
+            }
+            sockaddr_in socketAddress;
+            std::memset(&socketAddress, 0, sizeof(socketAddress));
+            socketAddress.sin_family = AF_INET;
+            socketAddress.sin_port = htons((uint16_t) portNumber);
+            socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+            int reuse = 1;
+            if(m_listenSocket >= 0) {
+                setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            }
+            if(m_listenSocket < 0 || bind(m_listenSocket, (sockaddr*) &socketAddress, sizeof(socketAddress)) != 0) {
+                error = "Cannot bind port " + port + ": " + std::strerror(errno);
+                return false;
+            }
+        }
+        if(::listen(m_listenSocket, 1) != 0) {
+            error = std::string("Cannot listen: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    }
+
+    bool GdbServer::serve(std::string &error) {
+        m_socket = accept(m_listenSocket, nullptr, nullptr);
+        if(m_socket < 0) {
+            error = std::string("Cannot accept a connection: ") + std::strerror(errno);
+            return false;
+        }
+        m_input.clear();
+        m_inputPosition = 0;
+        m_noAck = false;
+        std::string packet;
+        while(readPacket(packet)) {
+            std::string reply;
+            bool running = handlePacket(packet, reply);
+            // Console text goes out before the reply it belongs to
+            if(!flushConsole()) {
+                break;
+            }
+            if(!running) {
+                if(packet[0] == 'D') {
+                    sendPacket(reply);
+                }
+                close(m_socket);
+                m_socket = -1;
+                return true;
+            }
+            if(!sendPacket(reply)) {
+                break;
+            }
+            if(packet == "QStartNoAckMode") {
+                m_noAck = true;
+            }
+        }
+        close(m_socket);
+        m_socket = -1;
+        error = "Client disconnected";
+        return false;
+    }
+
+    bool GdbServer::readByte(char &c) {
+        if(m_inputPosition == m_input.size()) {
+            char buffer[4096];
+            ssize_t size = recv(m_socket, buffer, sizeof(buffer), 0);
+            if(size <= 0) {
+                return false;
+            }
+            m_input.assign(buffer, (size_t) size);
+            m_inputPosition = 0;
+        }
+        c = m_input[m_inputPosition++];
+        return true;
+    }
+
+    bool GdbServer::readPacket(std::string &packet) {
+        char c;
+        while(readByte(c)) {
+            if(c == '\x03') {
+                packet = "\x03";
+                return true;
+            }
+            if(c != '$') {
+                // Acks and noise between packets
+                continue;
+            }
+            packet.clear();
+            uint8_t checksum = 0;
+            bool escaped = false;
+            while(readByte(c) && c != '#') {
+                checksum += (uint8_t) c;
+                if(escaped) {
+                    packet += (char) (c ^ 0x20);
+                    escaped = false;
+                } else if(c == '}') {
+                    escaped = true;
+                } else {
+                    packet += c;
+                }
+            }
+            char high, low;
+            if(c != '#' || !readByte(high) || !readByte(low)) {
+                return false;
+            }
+            if(m_noAck) {
+                return true;
+            }
+            bool valid = std::strtol(std::string({high, low}).c_str(), nullptr, 16) == checksum;
+            if(send(m_socket, valid ? "+" : "-", 1, MSG_NOSIGNAL) != 1) {
+                return false;
+            }
+            if(valid) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool GdbServer::sendPacket(const std::string &payload) {
+        uint8_t checksum = 0;
+        for(char c : payload) {
+            checksum += (uint8_t) c;
+        }
+        static const char digits[] = "0123456789abcdef";
+        std::string packet = "$" + payload + "#" + digits[checksum >> 4] + digits[checksum & 0xf];
+        while(true) {
+            size_t sent = 0;
+            while(sent < packet.size()) {
+                ssize_t size = send(m_socket, packet.data() + sent, packet.size() - sent, MSG_NOSIGNAL);
+                if(size <= 0) {
+                    return false;
+                }
+                sent += (size_t) size;
+            }
+            if(m_noAck) {
+                return true;
+            }
+            // Resend until acknowledged
+            char c;
+            do {
+                if(!readByte(c)) {
+                    return false;
+                }
+            } while(c != '+' && c != '-');
+            if(c == '+') {
+                return true;
+            }
+        }
+    }
+
+    bool GdbServer::flushConsole() {
+        size_t chunk = (PACKET_SIZE - 1) / 2;
+        for(size_t i=0; i < m_console.size(); i += chunk) {
+            size_t size = std::min(chunk, m_console.size() - i);
+            if(!sendPacket("O" + toHex((const uint8_t*) m_console.data() + i, size))) {
+                return false;
+            }
+        }
+        m_console.clear();
+        return true;
+    }
+
+    bool GdbServer::handlePacket(const std::string &packet, std::string &reply) {
+        auto executor = m_session->getExecutor();
+        uint64_t address = 0;
+        uint64_t length = 0;
+        switch(packet[0]) {
+            case '\x03':
+            case '?':
+                reply = getStopReply();
+                break;
+            case 'g':
+                reply = readRegisters();
+                break;
+            case 'p': {
+                uint64_t index = 0;
+                reply = parseHex(packet.substr(1), index) && index < REGISTER_COUNT ? readRegister((int) index)
+                                                                                    : "E45";
+                break;
+            }
+            case 'm':
+            case 'x': {
+                std::vector<uint8_t> bytes;
+                if(!parseRange(packet.substr(1), address, length)) {
+                    reply = "E01";
+                } else if(packet[0] == 'x' && length == 0) {
+                    // Probe for binary support
+                    reply = "OK";
+                // Hex and escaped binary replies at most double the length
+                } else if(!readMemory(address, std::min<uint64_t>(length, (PACKET_SIZE - 4) / 2), bytes)) {
+                    reply = "E14";
+                } else if(packet[0] == 'm') {
+                    reply = toHex(bytes.data(), bytes.size());
+                } else {
+                    reply = (m_binaryUpload ? "b" : "") + escape(bytes.data(), bytes.size());
+                }
+                break;
+            }
+            case 'Z':
+            case 'z': {
+                // Software breakpoints only, addresses are instruction offsets
+                size_t kindComma = packet.rfind(',');
+                if(packet.compare(1, 2, "0,") != 0 || kindComma < 3
+                   || !parseHex(packet.substr(3, kindComma - 3), address)) {
+                    reply = "";
+                    break;
+                }
+                int line = m_session->getLine((uint32_t) address);
+                if(line == 0 || !executor) {
+                    reply = "E01";
+                } else if(packet[0] == 'Z') {
+                    reply = m_session->addBreakpoint(line) ? "OK" : "E01";
+                } else {
+                    reply = m_session->removeBreakpoint(line) ? "OK" : "E01";
+                }
+                break;
+            }
+            case 'c':
+            case 's':
+                m_session->execute(packet[0] == 'c' ? "continue" : "step");
+                reply = getStopReply();
+                break;
+            case 'v':
+                if(packet == "vCont?") {
+                    reply = "vCont;c;s";
+                } else if(packet.compare(0, 6, "vCont;") == 0 && packet.size() > 6
+                          && (packet[6] == 'c' || packet[6] == 's')) {
+                    m_session->execute(packet[6] == 'c' ? "continue" : "step");
+                    reply = getStopReply();
+                } else {
+                    reply = "";
+                }
+                break;
+            case 'H':
+            case 'T':
+                // Single thread
+                reply = "OK";
+                break;
+            case 'D':
+                reply = "OK";
+                return false;
+            case 'k':
+                return false;
+            case 'q':
+            case 'Q':
+                reply = handleQuery(packet);
+                break;
+            default:
+                // Unsupported, including memory and register writes
+                reply = "";
+                break;
+        }
+        return true;
+    }
+
+    std::string GdbServer::handleQuery(const std::string &packet) {
+        if(packet.compare(0, 10, "qSupported") == 0) {
+            m_binaryUpload = packet.find("binary-upload+") != std::string::npos;
+            std::stringstream ss;
+            ss << "PacketSize=" << std::hex << PACKET_SIZE
+               << ";QStartNoAckMode+;qXfer:features:read+;swbreak+;binary-upload+";
+            return ss.str();
+        }
+        if(packet == "QStartNoAckMode" || packet == "qSymbol::") {
+            return "OK";
+        }
+        if(packet == "qAttached") {
+            return "1";
+        }
+        if(packet == "qC") {
+            return "QC1";
+        }
+        if(packet == "qfThreadInfo") {
+            return "m1";
+        }
+        if(packet == "qsThreadInfo") {
+            return "l";
+        }
+        if(packet == "qOffsets") {
+            return "Text=0;Data=0;Bss=0";
+        }
+        std::string xfer = "qXfer:features:read:target.xml:";
+        if(packet.compare(0, xfer.size(), xfer) == 0) {
+            uint64_t offset = 0;
+            uint64_t length = 0;
+            if(!parseRange(packet.substr(xfer.size()), offset, length)) {
+                return "E01";
+            }
+            std::string description = getTargetDescription();
+            if(offset >= description.size()) {
+                return "l";
+            }
+            std::string part = description.substr(offset, std::min<uint64_t>(length, PACKET_SIZE - 5));
+            return (offset + part.size() < description.size() ? "m" : "l")
+                   + escape((const uint8_t*) part.data(), part.size());
+        }
+        if(packet.compare(0, 13, "qRegisterInfo") == 0) {
+            // Register layout for lldb, which does not read target.xml by default
+            uint64_t index = 0;
+            if(!parseHex(packet.substr(13), index) || index >= REGISTER_COUNT) {
+                return "E45";
+            }
+            std::stringstream ss;
+            if(index == REGISTER_PC) {
+                ss << "name:pc;bitsize:32;offset:0;encoding:uint;format:hex;set:General Purpose Registers;"
+                   << "generic:pc;";
+            } else if(index == REGISTER_SP) {
+                ss << "name:sp;bitsize:32;offset:4;encoding:uint;format:hex;set:General Purpose Registers;"
+                   << "generic:sp;";
+            } else {
+                ss << "name:stack" << index - 2 << ";bitsize:64;offset:" << 8 + (index - 2) * 8
+                   << ";encoding:uint;format:hex;set:Stack;";
+            }
+            return ss.str();
+        }
+        if(packet.compare(0, 6, "qRcmd,") == 0) {
+            // monitor <debugger command>
+            m_session->execute(fromHex(packet.substr(6)));
+            return "OK";
+        }
+        return "";
+    }
+
+    std::string GdbServer::getStopReply() const {
+        auto executor = m_session->getExecutor();
+        if(!executor) {
+            return "W01";
+        }
+        if(executor->MainFunctionIsSet() && executor->MainFunctionHasReturned()) {
+            return "W00";
+        }
+        return "S05";
+    }
+
+    std::string GdbServer::readRegisters() const {
+        std::string registers;
+        for(int i=0; i < REGISTER_COUNT; i++) {
+            registers += readRegister(i);
+        }
+        return registers;
+    }
+
+    std::string GdbServer::readRegister(int index) const {
+        auto executor = m_session->getExecutor();
+        if(index == REGISTER_PC || index == REGISTER_SP) {
+            if(!executor) {
+                return "xxxxxxxx";
+            }
+            uint32_t value = index == REGISTER_PC ? executor->GetPcOffset() : (uint32_t) executor->GetStackSize();
+            // Little endian
+            uint8_t bytes[4] = {(uint8_t) value, (uint8_t) (value >> 8), (uint8_t) (value >> 16),
+                                (uint8_t) (value >> 24)};
+            return toHex(bytes, sizeof(bytes));
+        }
+        int slot = index - 2;
+        if(!executor || slot >= executor->GetStackSize()) {
+            return "xxxxxxxxxxxxxxxx";
+        }
+        uint64_t value = executor->GetStackAt(executor->GetStackSize() - slot - 1).i64;
+        uint8_t bytes[8];
+        for(int i=0; i < 8; i++) {
+            bytes[i] = (uint8_t) (value >> (8 * i));
+        }
+        return toHex(bytes, sizeof(bytes));
+    }
+
+    bool GdbServer::readMemory(uint64_t address, uint64_t length, std::vector<uint8_t> &bytes) const {
+        auto executor = m_session->getExecutor();
+        if(!executor || executor->GetMemoriesCount() == 0) {
+            return false;
+        }
+        uint64_t size = (uint64_t) executor->GetMemorySize(0);
+        if(address >= size) {
+            return false;
+        }
+        // Short read at the end of the memory
+        length = std::min(length, size - address);
+        bytes.resize((size_t) length);
+        for(uint64_t i=0; i < length; i++) {
+            bytes[i] = (uint8_t) executor->GetMemoryAt(0, (int) (address + i));
+        }
+        return true;
+    }
+
+    std::string GdbServer::getTargetDescription() {
+        std::stringstream ss;
+        ss << "<?xml version=\"1.0\"?>\n"
+           << "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">\n"
+           << "<target version=\"1.0\">\n"
+           << "  <feature name=\"org.wdb.wasm\">\n"
+           << "    <reg name=\"pc\" bitsize=\"32\" type=\"code_ptr\" regnum=\"0\"/>\n"
+           << "    <reg name=\"sp\" bitsize=\"32\" type=\"uint32\" regnum=\"1\"/>\n";
+        for(int i=0; i < STACK_REGISTERS; i++) {
+            ss << "    <reg name=\"stack" << i << "\" bitsize=\"64\" type=\"uint64\" regnum=\"" << i + 2 << "\"/>\n";
+        }
+        ss << "  </feature>\n"
+           << "</target>\n";
+        return ss.str();
+    }
+
+    std::string GdbServer::toHex(const uint8_t *data, size_t size) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex(size * 2, '0');
+        for(size_t i=0; i < size; i++) {
+            hex[2 * i] = digits[data[i] >> 4];
+            hex[2 * i + 1] = digits[data[i] & 0xf];
+        }
+        return hex;
+    }
+
+    std::string GdbServer::escape(const uint8_t *data, size_t size) {
+        std::string escaped;
+        escaped.reserve(size);
+        for(size_t i=0; i < size; i++) {
+            char c = (char) data[i];
+            if(c == '#' || c == '$' || c == '}' || c == '*') {
+                escaped += '}';
+                c = (char) (c ^ 0x20);
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+}
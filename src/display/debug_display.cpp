@@ -1,31 +1,50 @@
 #include <wdb_tui/debug_display.h>
 #include <wabt/src/cast.h>
 #include <wdb_tui/common.h>
+#include <wdb_tui/timings.h>
+#include <wdb_tui/frame_stats.h>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
-#include <regex>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 namespace wdb {
-    DebugDisplay::DebugDisplay(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options) :
+    DebugDisplay::DebugDisplay(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options,
+                               wdb::ModuleIndex *moduleIndex) :
             Display(DISPLAYS_LINES, DISPLAYS_COLS, 0, SIDE_MENU_COLS) {
+        ScopedTimer timer("debug display");
         // Enable keypad on this window
         keypad(m_CDKScreen->window, true);
-        // Set wasm interpreter
-        m_wdbWabt = wdbWabt;
+        m_frameName = "debug";
         // Set default panel in focus
         m_focusPanel = COMMAND;
         // Init command history with one element
         m_commandHistory = {{}};
-        // Configure executor options
-        m_executorOptions.preSetup = options.preSetup;
-        m_executorOptions.outputStreamHandler = std::bind(&DebugDisplay::outputStreamHandler, this, std::placeholders::_1);
-        m_executorOptions.errorStreamHandler = std::bind(&DebugDisplay::errorStreamHandler, this, std::placeholders::_1);
-        // Create a default executor
-        m_executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_executorOptions);
+        // Program output is coalesced, command messages are whole lines
+        m_session.reset(new wdb::DebugSession(wdbWabt, options, [this](const std::string &text) {
+            m_console.write(text);
+        }, [this](const std::string &text) {
+            m_console.addLine(text);
+        }, moduleIndex));
+        // Register console commands
+        registerCommands();
+    }
+
+    short DebugDisplay::getHeatColor(uint64_t count) const {
+        auto &blockProfile = m_session->getBlockProfile();
+        if(count == 0 || blockProfile.getMaxCount() == 0) {
+            return WDB_COLOR_NORMAL;
+        }
+        // Logarithmic scale, hottest block is the reference
+        double ratio = std::log((double) count + 1) / std::log((double) blockProfile.getMaxCount() + 1);
+        int level = std::min(3, (int) (ratio * 4));
+        return (short) (WDB_COLOR_HEAT_1 + level);
     }
 
     std::string DebugDisplay::getMemoryHex(int byteIndex, int size) {
+        auto executor = m_session->getExecutor();
         std::stringstream ssHex;
         std::stringstream ssASCII;
         // Add address
@@ -36,8 +55,8 @@ namespace wdb {
                 ssHex << " ";
             }
             int currentIndex = i + byteIndex;
-            if(currentIndex < m_executor->GetMemorySize(m_memoIndex)) {
-                int currentData = m_executor->GetMemoryAt(m_memoIndex, currentIndex) & 0xff;
+            if(currentIndex < executor->GetMemorySize(m_memoIndex)) {
+                int currentData = executor->GetMemoryAt(m_memoIndex, currentIndex) & 0xff;
                 ssHex << std::setfill('0') << std::setw(2) << std::hex << currentData;
                 // If char is printable
                 if(std::isprint(currentData)) {
@@ -55,6 +74,8 @@ namespace wdb {
     }
 
     void DebugDisplay::updateStack() {
+        ScopedFrameSection section("stack");
+        auto executor = m_session->getExecutor();
         // Update position
         int topLeftY = 1;
         int topLeftX = 1;
@@ -64,49 +85,173 @@ namespace wdb {
         int numCols = getNumCols() - (2 * topLeftX);
 
         // Draw border around stack
-        drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == STACK, "(top) - STACK - (bottom)");
+        drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == STACK,
+                   std::string("(top) - STACK [") + getStackViewName(m_stackView) + "] - (bottom)");
 
         // Check if stack is empty or no executor
-        if(m_executor->GetStackSize() == 0) {
+        int stackSize = executor->GetStackSize();
+        if(stackSize == 0) {
             // Draw stack is empty message
             std::string message = "Stack is empty";
             int messageY = topLeftY + numLines/2;
             int messageX = topLeftX + numCols/2 - (int)message.size()/2;
             drawMessage(messageY, messageX, message.size(), WDB_COLOR_NORMAL, A_ITALIC, message);
         } else {
-            // Prepare table data
-            size_t valueSize = 16; // 128-bits for the v128 type
-            std::vector<std::vector<std::string>> stackData(valueSize/4); // 4-bytes per line
-            int valueNumCols = 11;
-            int visibleValues = numCols / valueNumCols;
-            // Prepare table header
+            int visibleValues = std::max(1, numCols / getStackViewCols(m_stackView));
+            // Scroll to the highlighted value
+            m_stackLeftIndex = std::max(0, std::min(m_stackLeftIndex, stackSize - visibleValues));
+            m_stackHighlightColIndex = std::max(0, std::min(m_stackHighlightColIndex, stackSize - 1));
+            if(m_stackLeftIndex > m_stackHighlightColIndex) {
+                m_stackLeftIndex = m_stackHighlightColIndex;
+            } else if(m_stackLeftIndex + visibleValues <= m_stackHighlightColIndex) {
+                m_stackLeftIndex = m_stackHighlightColIndex - visibleValues + 1;
+            }
+            int windowSize = std::min(visibleValues, stackSize - m_stackLeftIndex);
+            // Only visible values are formatted, and only when they changed since the last frame
+            m_stackSlots.resize((size_t) stackSize);
             std::vector<std::string> header;
-            for(int i=0; i < m_executor->GetStackSize(); i++) {
-                // Create header
-                header.push_back(std::to_string(m_executor->GetStackSize() - i));
-                // Copy stack value into a byte array
-                wabt::interp::Value currentVal = m_executor->GetStackAt(m_executor->GetStackSize() - i - 1);
-                uint8_t stackBytes[valueSize];
-                memcpy(stackBytes, &currentVal, valueSize);
-                for(int j=0; j < stackData.size(); j++) {
-                    std::stringstream ss;
-                    ss << " "
-                       << std::setfill('0') << std::setw(2) << std::hex << (int) stackBytes[j*4+3]
-                       << std::setfill('0') << std::setw(2) << std::hex << (int) stackBytes[j*4+2] << " "
-                       << std::setfill('0') << std::setw(2) << std::hex << (int) stackBytes[j*4+1]
-                       << std::setfill('0') << std::setw(2) << std::hex << (int) stackBytes[j*4];
-                    stackData[stackData.size()-1-j].push_back(ss.str());
+            std::vector<std::vector<std::string>> stackData(STACK_VALUE_LINES);
+            for(int i=m_stackLeftIndex; i < m_stackLeftIndex + windowSize; i++) {
+                header.push_back(std::to_string(stackSize - i));
+                wabt::interp::Value currentVal = executor->GetStackAt(stackSize - i - 1);
+                StackSlot &slot = m_stackSlots[stackSize - i - 1];
+                if(slot.lines.empty() || slot.view != m_stackView
+                   || memcmp(&slot.value, &currentVal, sizeof(currentVal)) != 0) {
+                    slot.value = currentVal;
+                    slot.view = m_stackView;
+                    slot.lines = formatStackValue(currentVal, m_stackView);
+                }
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    stackData[j].push_back(slot.lines[j]);
                 }
             }
-            // Draw table
+            // Draw the window, scrolling was done above
             int topIndex = 0;
+            int leftIndex = 0;
             int highlightLine = 0;
-            drawTable(topLeftY, topLeftX, numLines, numCols, header, stackData, header.size(), visibleValues, topIndex,
-                      m_stackLeftIndex, highlightLine, m_stackHighlightColIndex, Highlight::HCOLUMN, true);
+            int highlightCol = m_stackHighlightColIndex - m_stackLeftIndex;
+            drawTable(topLeftY, topLeftX, numLines, numCols, header, stackData, windowSize, visibleValues, topIndex,
+                      leftIndex, highlightLine, highlightCol, Highlight::HCOLUMN, true);
+        }
+    }
+
+    std::vector<std::string> DebugDisplay::formatStackValue(const wabt::interp::Value &value, StackView view) {
+        // Decode all lanes at once from the 128-bit value
+        uint8_t bytes[16];
+        memcpy(bytes, &value, sizeof(bytes));
+        std::vector<std::string> lines(STACK_VALUE_LINES);
+        char text[64];
+        switch(view) {
+            case STACK_HEX:
+            default:
+                // Most significant word on top
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    std::snprintf(text, sizeof(text), " %02x%02x %02x%02x", bytes[j*4+3], bytes[j*4+2], bytes[j*4+1],
+                                  bytes[j*4]);
+                    lines[STACK_VALUE_LINES-1-j] = text;
+                }
+                break;
+            case STACK_I32: {
+                int32_t number;
+                memcpy(&number, bytes, sizeof(number));
+                std::snprintf(text, sizeof(text), " %d", number);
+                lines[0] = text;
+                break;
+            }
+            case STACK_I64: {
+                int64_t number;
+                memcpy(&number, bytes, sizeof(number));
+                std::snprintf(text, sizeof(text), " %lld", (long long) number);
+                lines[0] = text;
+                break;
+            }
+            case STACK_F32: {
+                float number;
+                memcpy(&number, bytes, sizeof(number));
+                std::snprintf(text, sizeof(text), " %.9g", number);
+                lines[0] = text;
+                break;
+            }
+            case STACK_F64: {
+                double number;
+                memcpy(&number, bytes, sizeof(number));
+                std::snprintf(text, sizeof(text), " %.17g", number);
+                lines[0] = text;
+                break;
+            }
+            case STACK_I8X16: {
+                // Lane 0 on top
+                int8_t lanes[16];
+                memcpy(lanes, bytes, sizeof(lanes));
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    std::snprintf(text, sizeof(text), " %4d %4d %4d %4d", lanes[j*4], lanes[j*4+1], lanes[j*4+2],
+                                  lanes[j*4+3]);
+                    lines[j] = text;
+                }
+                break;
+            }
+            case STACK_I16X8: {
+                int16_t lanes[8];
+                memcpy(lanes, bytes, sizeof(lanes));
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    std::snprintf(text, sizeof(text), " %6d %6d", lanes[j*2], lanes[j*2+1]);
+                    lines[j] = text;
+                }
+                break;
+            }
+            case STACK_I32X4: {
+                int32_t lanes[4];
+                memcpy(lanes, bytes, sizeof(lanes));
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    std::snprintf(text, sizeof(text), " %d", lanes[j]);
+                    lines[j] = text;
+                }
+                break;
+            }
+            case STACK_F32X4: {
+                float lanes[4];
+                memcpy(lanes, bytes, sizeof(lanes));
+                for(int j=0; j < STACK_VALUE_LINES; j++) {
+                    std::snprintf(text, sizeof(text), " %.9g", lanes[j]);
+                    lines[j] = text;
+                }
+                break;
+            }
         }
+        return lines;
+    }
+
+    int DebugDisplay::getStackViewCols(StackView view) {
+        // Widest value with its leading space, plus a separator
+        switch(view) {
+            case STACK_HEX:
+            default:
+                return 11;
+            case STACK_I32:
+            case STACK_I32X4:
+                return 13;
+            case STACK_I64:
+                return 22;
+            case STACK_F32:
+            case STACK_F32X4:
+                return 17;
+            case STACK_F64:
+                return 26;
+            case STACK_I8X16:
+                return 21;
+            case STACK_I16X8:
+                return 15;
+        }
+    }
+
+    const char* DebugDisplay::getStackViewName(StackView view) {
+        static const char* names[] = {"hex", "i32", "i64", "f32", "f64", "i8x16", "i16x8", "i32x4", "f32x4"};
+        return view < STACK_VIEW_COUNT ? names[view] : "";
     }
 
     void DebugDisplay::updateCode() {
+        ScopedFrameSection section("code");
+        auto executor = m_session->getExecutor();
         // Update position
         int topLeftY = (getNumLines() / 5) + 1;
         int topLeftX = 1;
@@ -118,20 +263,35 @@ namespace wdb {
         // Draw border around stack
         drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == CODE, "CODE");
         // Populate code
-        m_instructions = m_executor->DisassembleModule(m_executor->GetMainModule());
         std::vector<std::string> code = generateDebugCode();
         // Draw code list
         Display::Highlight highlight = Highlight::HCLEAR;
         bool follow = false;
-        if(m_executor->MainFunctionIsSet() && !m_executor->MainFunctionHasReturned()) {
+        if(executor->MainFunctionIsSet() && !executor->MainFunctionHasReturned()) {
             highlight = Highlight::HLINE;
             follow = true;
         }
         drawList(topLeftY, topLeftX, numLines, numCols, code, m_codeTopIndex, m_codeHighlightLineIndex, highlight,
                  follow);
+        // Color lines by block hotness
+        auto tracer = m_session->getTracer();
+        if(m_heatMap && tracer) {
+            for(int i=0; i < numLines && m_codeTopIndex + i < tracer->getInstructions().size(); i++) {
+                int line = m_codeTopIndex + i;
+                if(highlight == Highlight::HLINE && line == m_codeHighlightLineIndex) {
+                    continue;
+                }
+                short color = getHeatColor(m_session->getBlockProfile().getCount(tracer->getInstruction(line).block));
+                if(color != WDB_COLOR_NORMAL) {
+                    mvwchgat(m_CDKScreen->window, topLeftY + i, topLeftX, numCols, A_NORMAL, color, nullptr);
+                }
+            }
+        }
     }
 
     void DebugDisplay::updateMemory() {
+        ScopedFrameSection section("memory");
+        auto executor = m_session->getExecutor();
         // Update position
         int topLeftY = (getNumLines() / 5) + 1;
         int topLeftX = getNumCols() / 2;
@@ -142,12 +302,12 @@ namespace wdb {
 
         // Draw border around stack
         std::string memoryTitle = "MEMORY";
-        if(m_executor->GetMemoriesCount() > 0) {
+        if(executor->GetMemoriesCount() > 0) {
             memoryTitle += " #" + std::to_string(m_memoIndex);
         }
         drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == MEMORY, memoryTitle.c_str());
         // Check if at least one memory exit
-        if(m_executor->GetMemoriesCount() == 0) {
+        if(executor->GetMemoriesCount() == 0) {
             // Draw not memory found message
             std::string message = "No memory found";
             int messageY = topLeftY + numLines / 2;
@@ -163,6 +323,7 @@ namespace wdb {
     }
 
     void DebugDisplay::updateCommand() {
+        ScopedFrameSection section("command");
         // Update position
         int topLeftY = getNumLines() / 5 + (int)(getNumLines()  /2.5) + 1;
         int topLeftX = 1;
@@ -179,16 +340,21 @@ namespace wdb {
                                        m_commandHistory[m_commandHistoryScroll].end()));
         // Draw cursor
         drawCursor(topLeftY + numLines-1, topLeftX+2, numCols-2, m_currentCommandIndex);
-        // Draw output
+        // Draw visible output only
+        int outputLines = std::max(numLines-2, 0);
+        m_consoleTopIndex = std::min(m_consoleTopIndex, (int) m_console.getSize() - outputLines);
+        m_consoleTopIndex = std::max(m_consoleTopIndex, 0);
+        std::vector<std::string> visibleOutput = m_console.getLines((size_t) m_consoleTopIndex, (size_t) outputLines);
+        int topIndex = 0;
         int highlightTopIndex = 0;
-        drawList(topLeftY, topLeftX, numLines-2, numCols, m_consoleOutput, m_consoleTopIndex, highlightTopIndex,
+        drawList(topLeftY, topLeftX, outputLines, numCols, visibleOutput, topIndex, highlightTopIndex,
                  Highlight::HCLEAR, false);
     }
 
     void DebugDisplay::update() {
         // Erase window
         werase(m_CDKScreen->window);
-        if(m_executor) {
+        if(m_session->getExecutor()) {
             // Update panels
             updateStack();
             updateCommand();
@@ -196,7 +362,8 @@ namespace wdb {
             updateMemory();
             // Draw instructions
             drawMessage(getNumLines()-2, 1, getNumCols()-2, WDB_COLOR_INFO, A_BOLD,
-                        "<TAB>Focus <F1>Console-Up <F2>Console-Down <PAGE-UP>Prev-Memo <PAGE-DOWN>Next-Memo");
+                        "<TAB>Focus <F1>Console-Up <F2>Console-Down <PAGE-UP>Prev-Memo <PAGE-DOWN>Next-Memo "
+                        "<h>Heat-Map <v>Stack-View");
         } else {
             drawDialog("Error", "Error creating an executor, please verify the wasm file is valid", WDB_COLOR_ERROR,
                        A_BOLD);
@@ -213,171 +380,67 @@ namespace wdb {
 
         // Reset stack variables
         m_stackLeftIndex = 0;
+        m_stackSlots.clear();
+    }
+
+    void DebugDisplay::registerCommands() {
+        auto &commands = m_session->getCommands();
+        commands.add({"clear", {}, {}, "", "Clear console", [this](const DebugSession::Arguments &arguments) {
+            m_console.clear();
+        }});
+        commands.add({"restart", {}, {}, "", "Debug function", [this](const DebugSession::Arguments &arguments) {
+            // Reset debugger display
+            reset();
+            // Create a new executor
+            m_session->restart();
+        }});
     }
 
     void DebugDisplay::handleCommand(std::string command) {
-        std::istringstream ssCommand(command);
-        std::vector<std::string> commandVector{std::istream_iterator<std::string>{ssCommand},
-                                               std::istream_iterator<std::string>{}};
         // Log what was entered
-        m_consoleOutput.emplace_back("> "+command);
-        if(!commandVector.empty()) {
-            std::string commandPart = commandVector.front();
-            if(commandPart == "help" && commandVector.size() == 1) {
-                m_consoleOutput.emplace_back("Commands:");
-                m_consoleOutput.emplace_back("  help                    Display this message");
-                m_consoleOutput.emplace_back("  clear                   Clear console");
-                m_consoleOutput.emplace_back("  restart                 Debug function");
-                m_consoleOutput.emplace_back("  main     <func-name>    Set main function");
-                m_consoleOutput.emplace_back("  step                    Step into execution");
-                m_consoleOutput.emplace_back("  continue                Continue execution");
-                m_consoleOutput.emplace_back("  break    <pc>           Add breakpoint at given line");
-                m_consoleOutput.emplace_back("  breakrm  <pc>           Remove breakpoint at given line");
-                m_consoleOutput.emplace_back("  breakls                 List all breakpoint lines");
-                m_consoleOutput.emplace_back("  print                   Print to the console:");
-                m_consoleOutput.emplace_back("    stack[top=0].type     Stack value at an index with a type: i32, i64, f32, f64 or v128");
-            } else if(commandPart == "clear" && commandVector.size() == 1) {
-                m_consoleOutput.clear();
-            } else if(commandPart == "restart" && commandVector.size() == 1) {
-                // Reset debugger display
-                reset();
-                // Create a new executor
-                m_executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_executorOptions);
-            } else if(commandPart == "main" && commandVector.size() == 2) {
-                // Search for function
-                wabt::interp::Export* e = nullptr;
-                std::string funcName = commandVector[1];
-                if(m_executor->SearchExportedModuleFunction(
-                        m_executor->GetMainModule(), funcName, &e) == wabt::Result::Ok) {
-                    // Get function details
-                    auto func = m_executor->GetFunction(e->index);
-                    // Set the main function
-                    if(m_executor->SetMainFunction(func) == wabt::Result::Ok) {
-                        m_consoleOutput.emplace_back("Program main function set to '" + funcName +"'");
-                    } else {
-                        m_consoleOutput.emplace_back("Failed to set '" + funcName + "' main function");
-                    }
-                } else {
-                    m_consoleOutput.emplace_back("Function '" + funcName + "' was not found");
-                }
-            } else if(commandPart == "step" && commandVector.size() == 1) {
-                if(m_executor->ExecuteNextInstruction() != wabt::Result::Ok) {
-                    m_consoleOutput.emplace_back("Cannot execute next instruction");
-                }
-            } else if(commandPart == "continue" && commandVector.size() == 1) {
-                if(m_executor->Execute() != wabt::Result::Ok) {
-                    m_consoleOutput.emplace_back("Cannot continue executing instructions");
-                }
-            } else if(commandPart == "print" && commandVector.size() == 2) {
-                // Parse the second argument
-                std::regex printArg(R"(^(stack|memo)\[([0-9]{1,5})\]\.(i32|i64|f32|f64|v128)$)");
-                std::smatch printArgMatch;
-                std::regex_search(commandVector[1], printArgMatch, printArg);
-
-                // If match was found
-                if (!printArgMatch.empty()) {
-                    // Load matched groups into variables
-                    std::string variable = printArgMatch[1];
-                    int index = std::stoi(printArgMatch[2]);
-                    std::string type = printArgMatch[3];
-                    // For stack variable
-                    if (variable == "stack") {
-                        // Check for index out of bound
-                        if (index < 0 || index >= m_executor->GetStackSize()) {
-                            m_consoleOutput.emplace_back("Index out of stack bound");
-                        } else {
-                            // Prepare a typed value for easy printing
-                            wabt::interp::TypedValue valType;
-                            // Fetch stack entry
-                            auto stackEntry =
-                                    m_executor->GetStackAt(m_executor->GetStackSize() - index - 1);
-                            // Check the type
-                            if (type == "i32") {
-                                valType.type = wabt::Type::I32;
-                            } else if (type == "i64") {
-                                valType.type = wabt::Type::I64;
-                            } else if (type == "f32") {
-                                valType.type = wabt::Type::F32;
-                            } else if (type == "f64") {
-                                valType.type = wabt::Type::F64;
-                            } else if (type == "v128") {
-                                valType.type = wabt::Type::V128;
-                            }
-                            valType.value = stackEntry;
-                            m_consoleOutput.emplace_back(wabt::interp::TypedValueToString(valType));
-                        }
-                    } else if (variable == "memo") {
-                        // TODO
-                        m_consoleOutput.emplace_back("No yet implemented");
-                    }
-                } else {
-                    m_consoleOutput.emplace_back("Please type 'help' for a list of print commands");
-                }
-            } else if(commandPart == "break" && commandVector.size() == 2) {
-                // Parse the second argument
-                std::regex breakArg(R"(^([1-9][0-9]*)$)");
-                std::smatch breakArgMatch;
-                std::regex_search(commandVector[1], breakArgMatch, breakArg);
-
-                // If match was found
-                if (!breakArgMatch.empty()) {
-                    int line =  std::stoi(commandVector[1]);
-                    if(!addBreakpoint(line)) {
-                        m_consoleOutput.emplace_back("Breakpoint line number is out of bound");
-                    }
-                } else {
-                    m_consoleOutput.emplace_back("Error reading the breakpoint offset");
-                }
-            } else if(commandPart == "breakrm" && commandVector.size() == 2) {
-                // Parse the second argument
-                std::regex breakArg(R"(^([1-9][0-9]*)$)");
-                std::smatch breakArgMatch;
-                std::regex_search(commandVector[1], breakArgMatch, breakArg);
+        m_console.addLine("> "+command);
+        if(m_session->execute(command) != CommandRegistry::EMPTY) {
+            // Scroll console
+            m_consoleTopIndex = INT_MAX;
+        }
+    }
 
-                // If match was found
-                if (!breakArgMatch.empty()) {
-                    int line =  std::stoi(commandVector[1]);
-                    if(!removeBreakpoint(line)) {
-                        m_consoleOutput.emplace_back("Breakpoint line number is out of bound");
-                    }
-                } else {
-                    m_consoleOutput.emplace_back("Error reading the breakpoint offset");
-                }
-            } else if(commandPart == "breakls" && commandVector.size() == 1) {
-                std::stringstream ss;
-                auto breakpoints = getBreakpoints();
-                ss << "[";
-                for(auto i = breakpoints.begin(); i != breakpoints.end(); i++) {
-                    if(i != breakpoints.begin()) {
-                        ss << ",";
-                    }
-                    ss << *i;
-                }
-                ss << "]";
-                m_consoleOutput.emplace_back(ss.str());
-            } else {
-                m_consoleOutput.emplace_back("Command '" + command + "' not found");
+    void DebugDisplay::completeCommand() {
+        std::vector<char> &currentCommand = m_commandHistory[m_commandHistoryScroll];
+        std::vector<std::string> candidates;
+        std::string line(currentCommand.begin(), currentCommand.end());
+        std::string completed = m_session->getCommands().complete(line, candidates);
+        // List candidates when the completion is ambiguous
+        if(candidates.size() > 1) {
+            std::string list;
+            for(auto &candidate : candidates) {
+                list += candidate + "  ";
             }
-            // Scroll console
+            m_console.addLine(list);
             m_consoleTopIndex = INT_MAX;
         }
+        currentCommand.assign(completed.begin(), completed.end());
+        m_currentCommandIndex = (int) currentCommand.size();
     }
 
     std::vector<std::string> DebugDisplay::generateDebugCode() {
+        auto executor = m_session->getExecutor();
         // Clear old debug code
         std::vector<std::string> code;
-        if(!m_instructions.empty()) {
-            int lineNumSpace = (int) (std::log10(m_instructions.size())+1);
+        auto &instructions = m_session->getInstructions();
+        auto &breakpoints = m_session->getBreakpoints();
+        if(!instructions.empty()) {
+            int lineNumSpace = (int) (std::log10(instructions.size())+1);
             int lineNum = 1;
             // Load string into vector of string
-            for(auto &instruction : m_instructions) {
+            for(auto &instruction : instructions) {
                 bool breakpoint = false;
                 // Highlight current line
-                if(m_executor->GetPcOffset() == instruction.istream_start) {
+                if(executor->GetPcOffset() == instruction.istream_start) {
                     m_codeHighlightLineIndex = lineNum - 1;
                 }
                 // Set breakpoint mark
-                if(m_breakLine.find(lineNum) != m_breakLine.end()) {
+                if(breakpoints.find(lineNum) != breakpoints.end()) {
                     breakpoint = true;
                 }
                 // Generate line of code
@@ -394,49 +457,26 @@ namespace wdb {
         return code;
     }
 
-    bool DebugDisplay::addBreakpoint(int line) {
-        if(line < 1 || line > m_instructions.size()) {
-            return false;
+    void DebugDisplay::setConsoleSpillFile(const std::string &fileName) {
+        if(!m_console.setSpillFile(fileName)) {
+            m_console.addLine("Cannot open console log " + fileName);
         }
-        m_executor->AddBreakpoint(m_instructions[line-1].istream_start);
-        m_breakLine.insert(line);
-        return true;
-    }
-
-    bool DebugDisplay::removeBreakpoint(int line) {
-        if(line < 1 || line > m_instructions.size()) {
-            return false;
-        }
-        m_executor->RemoveBreakpoint(m_instructions[line-1].istream_start);
-        for(auto i = m_breakLine.begin(); i != m_breakLine.end(); i++) {
-            if(*i == line) {
-                m_breakLine.erase(i);
-                break;
-            }
-        }
-        return true;
-    }
-
-    void DebugDisplay::outputStreamHandler(std::string text) {
-        m_consoleOutput.emplace_back(text);
-    }
-
-    void DebugDisplay::errorStreamHandler(std::string text) {
-        m_consoleOutput.emplace_back("[ERR] " + text);
     }
 
     void DebugDisplay::listen() {
         // Update and draw screen
         update();
         draw();
-        while(m_executor) {
-            int c = wgetch(m_CDKScreen->window);
+        while(m_session->getExecutor()) {
+            int c = getInput();
             // Quit
             if((m_focusPanel != COMMAND && c == 'q') || c == KEY_ESC) {
                 return;
             }
-            // Switch panel
-            if(c == KEY_TAB) {
+            // Switch panel, unless a command is being completed
+            bool completing = m_focusPanel == COMMAND && c == KEY_TAB
+                              && !m_commandHistory[m_commandHistoryScroll].empty();
+            if(c == KEY_TAB && !completing) {
                 m_focusPanel = static_cast<Panel>((m_focusPanel+1) % 4);
             }
             // Scroll output console
@@ -453,6 +493,8 @@ namespace wdb {
                         m_stackHighlightColIndex--;
                     } else if(c == KEY_RIGHT) {
                         m_stackHighlightColIndex++;
+                    } else if(c == 'v') {
+                        m_stackView = (StackView) ((m_stackView + 1) % STACK_VIEW_COUNT);
                     }
                     break;
                 case MEMORY:
@@ -469,7 +511,7 @@ namespace wdb {
                     } else if(c == KEY_RIGHT) {
                         m_memoByteStart++;
                     } else if(c == KEY_NPAGE) {
-                        if(m_memoIndex < m_executor->GetMemoriesCount()-1) {
+                        if(m_memoIndex < m_session->getExecutor()->GetMemoriesCount()-1) {
                             m_memoIndex++;
                         }
                     } else if(c == KEY_PPAGE) {
@@ -483,6 +525,10 @@ namespace wdb {
                         m_codeTopIndex--;
                     } else if(c == KEY_DOWN) {
                         m_codeTopIndex++;
+                    } else if(c == 'h') {
+                        // Blocks are only counted while the heat map is shown
+                        m_heatMap = !m_heatMap;
+                        m_session->setTraceBlocks(m_heatMap);
                     }
                     break;
                 case COMMAND:
@@ -531,6 +577,8 @@ namespace wdb {
                         if (m_currentCommandIndex < currentCommand.size()) {
                             m_currentCommandIndex++;
                         }
+                    } else if(c == KEY_TAB) {
+                        completeCommand();
                     } else if(c == KEY_END) {
                         m_currentCommandIndex = (int) currentCommand.size();
                     } else if(c == KEY_HOME) {
@@ -1,7 +1,9 @@
 #include <wdb_tui/display.h>
 #include <wdb_tui/common.h>
+#include <wdb_tui/frame_stats.h>
 #include <stdexcept>
 #include <cmath>
+#include <algorithm>
 
 namespace wdb {
     Display::Display(int numLines, int numCols, int topLeftY, int topLeftX) {
@@ -21,7 +23,26 @@ namespace wdb {
         } else {
             box(m_CDKScreen->window, 0, 0);
         }
+        // Show frame stats on the bottom border
+        auto &frameStats = FrameStats::get();
+        if(!m_frameName.empty() && frameStats.isOverlayVisible()) {
+            std::string summary = " " + frameStats.getSummary() + " ";
+            drawMessage(getNumLines()-1, 2, std::min((int) summary.size(), getNumCols()-4), WDB_COLOR_INFO, A_BOLD,
+                        summary);
+        }
         drawCDKScreen(m_CDKScreen);
+        frameStats.endFrame();
+    }
+
+    int Display::getInput() {
+        int c = wgetch(m_CDKScreen->window);
+        if(c == KEY_F(12)) {
+            FrameStats::get().toggleOverlay();
+        }
+        if(!m_frameName.empty()) {
+            FrameStats::get().beginFrame(m_frameName);
+        }
+        return c;
     }
 
     void Display::drawBorder(int &topLeftY, int &topLeftX, int &numLines, int &numCols, bool focus, std::string title) {
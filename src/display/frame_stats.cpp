@@ -0,0 +1,112 @@
+#include <wdb_tui/frame_stats.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace wdb {
+    const size_t FrameStats::WINDOW;
+
+    void FrameStats::Section::record(uint64_t time) {
+        histogram.record(time);
+        if(window.size() < WINDOW) {
+            window.push_back(time);
+        } else {
+            window[next] = time;
+        }
+        next = (next + 1) % WINDOW;
+    }
+
+    uint64_t FrameStats::Section::getRollingPercentile(double percentile) const {
+        if(window.empty()) {
+            return 0;
+        }
+        std::vector<uint64_t> sorted = window;
+        auto rank = (size_t) std::ceil(percentile / 100.0 * sorted.size());
+        rank = std::max(rank, (size_t) 1) - 1;
+        std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+        return sorted[rank];
+    }
+
+    FrameStats& FrameStats::get() {
+        static FrameStats frameStats;
+        return frameStats;
+    }
+
+    void FrameStats::beginFrame(const std::string &display) {
+        if(!m_enabled) {
+            return;
+        }
+        m_current = &m_displays[display];
+        m_current->frame.name = display;
+        m_frameStart = std::chrono::steady_clock::now();
+        m_inFrame = true;
+    }
+
+    void FrameStats::endFrame() {
+        if(!m_inFrame) {
+            return;
+        }
+        m_current->frame.record((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_frameStart).count());
+        m_inFrame = false;
+    }
+
+    void FrameStats::recordSection(const std::string &section, uint64_t time) {
+        if(!m_inFrame) {
+            return;
+        }
+        auto &sections = m_current->sections;
+        auto it = std::find_if(sections.begin(), sections.end(), [&section](const Section &s) {
+            return s.name == section;
+        });
+        if(it == sections.end()) {
+            sections.emplace_back();
+            sections.back().name = section;
+            it = sections.end() - 1;
+        }
+        it->record(time);
+    }
+
+    std::string FrameStats::getSummary() const {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(2);
+        if(!m_current || m_current->frame.window.empty()) {
+            ss << "Frame: no input yet";
+            return ss.str();
+        }
+        // Times in ms, p50/p99 over the latest frames
+        auto &frame = m_current->frame;
+        ss << "Frame p50/p99 " << frame.getRollingPercentile(50) / 1e6 << "/"
+           << frame.getRollingPercentile(99) / 1e6 << "ms";
+        for(auto &section : m_current->sections) {
+            ss << " | " << section.name << " " << section.getRollingPercentile(50) / 1e6 << "/"
+               << section.getRollingPercentile(99) / 1e6;
+        }
+        return ss.str();
+    }
+
+    void FrameStats::print(std::ostream &out) const {
+        out << "[Frame times]" << std::endl;
+        if(m_displays.empty()) {
+            out << "  No frames recorded" << std::endl;
+            return;
+        }
+        out << "  " << std::left << std::setw(24) << "display/section" << std::right << std::setw(8) << "frames"
+            << std::setw(12) << "p50 ms" << std::setw(12) << "p99 ms" << std::setw(12) << "max ms" << std::endl;
+        auto printSection = [&out](const std::string &name, const Section &section) {
+            auto &histogram = section.histogram;
+            out << "  " << std::left << std::setw(24) << name << std::right << std::setw(8) << histogram.getCount()
+                << std::fixed << std::setprecision(3)
+                << std::setw(12) << histogram.getPercentile(50) / 1e6
+                << std::setw(12) << histogram.getPercentile(99) / 1e6
+                << std::setw(12) << histogram.getMax() / 1e6 << std::endl;
+        };
+        for(auto &display : m_displays) {
+            printSection(display.first, display.second.frame);
+            for(auto &section : display.second.sections) {
+                printSection("  " + section.name, section);
+            }
+        }
+    }
+}
@@ -22,4 +22,9 @@ namespace wdb {
     HomeDisplay::~HomeDisplay() {
         destroyCDKLabel(m_homeText);
     }
+
+    void HomeDisplay::setStatus(std::string message) {
+        drawMessage(getNumLines()-2, 1, getNumCols()-2, WDB_COLOR_INFO, A_BOLD, message);
+        draw();
+    }
 }
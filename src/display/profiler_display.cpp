@@ -1,12 +1,23 @@
 #include <wdb_tui/profiler_display.h>
 #include <wdb_tui/common.h>
+#include <wdb_tui/timings.h>
+#include <wdb_tui/frame_stats.h>
 #include <wabt/src/cast.h>
+#include <iomanip>
+#include <sstream>
 
 namespace wdb {
-    ProfilerDisplay::ProfilerDisplay(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options) :
-            Display(DISPLAYS_LINES, DISPLAYS_COLS, 0, SIDE_MENU_COLS) {
+    const int ProfilerDisplay::TOP_SEQUENCES;
+    const int ProfilerDisplay::TOP_PAGES;
+
+    ProfilerDisplay::ProfilerDisplay(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options,
+                                     const wdb::HeapProfile::Hooks &heapHooks, wdb::ModuleIndex *moduleIndex) :
+            Display(DISPLAYS_LINES, DISPLAYS_COLS, 0, SIDE_MENU_COLS),
+            m_moduleIndex(moduleIndex ? moduleIndex : &m_ownModuleIndex), m_heapProfile(heapHooks) {
+        ScopedTimer timer("profiler display");
         // Enable keypad on this window
         keypad(m_CDKScreen->window, true);
+        m_frameName = "profiler";
         // Set default sorting
         m_listSort = WdbProfilerExecutor::Sort::OPCODE_ASC;
         // Set wabt
@@ -14,7 +25,16 @@ namespace wdb {
         // Set options
         m_executorOptions.preSetup = options.preSetup;
         // Create a default executor
-        m_executor = m_wdbWabt->CreateWdbProfilerExecutor(m_executorOptions);
+        {
+            ScopedTimer instantiateTimer("instantiate");
+            m_executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_executorOptions);
+        }
+        // Function rows do not change between runs
+        m_moduleIndex->build(m_executor);
+        for(auto &function : m_moduleIndex->getFunctions()) {
+            m_funcData.push_back({function.module, function.name, function.params, function.results,
+                                  function.isHost ? "Yes" : "No", function.canRun ? "Yes" : "No"});
+        }
         // Set default panel focus
         m_focusPanel = FUNCTIONS;
     }
@@ -27,6 +47,7 @@ namespace wdb {
     }
 
     void ProfilerDisplay::updateFuncList() {
+        ScopedFrameSection section("functions");
         // Compute list offsets
         int topLeftY = 1;
         int topLeftX = 1;
@@ -38,57 +59,17 @@ namespace wdb {
         // Draw border
         drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == FUNCTIONS, "Functions");
 
-        // Clear list of functions
-        m_funcList.clear();
-        // Prepare data vector
-        std::vector<std::vector<std::string>> data;
-        // Fetch modules
-        for(int i=0; i < m_executor->GetModuleSize(); i++) {
-            auto currentModule = m_executor->GetModuleAt(i);
-            // Fetch functions in modules
-            auto functions = m_executor->GetExportedModuleFunctions(currentModule);
-            // Populate data
-            for (int j = 0; j < functions.size(); j++) {
-                auto moduleName = (currentModule == m_executor->GetMainModule()) ? "<main>" : currentModule->name;
-                auto currentFunction = functions[j];
-                auto func = m_executor->GetFunction(currentFunction.index);
-                auto funcSig = m_executor->GetFunctionSignature((func->sig_index));
-                // Create param string
-                std::stringstream params;
-                for(int i=0; i < funcSig->param_types.size(); i++) {
-                    if(i > 0 ){
-                        params << ",";
-                    }
-                    params << wabt::GetTypeName(funcSig->param_types[i]);
-                }
-                // Create results string
-                std::stringstream results;
-                for(int i=0; i < funcSig->result_types.size(); i++) {
-                    if(i > 0 ){
-                        results << ",";
-                    }
-                    results << wabt::GetTypeName(funcSig->result_types[i]);
-                }
-
-                m_funcList.emplace_back(currentFunction);
-                data.push_back({moduleName,
-                                currentFunction.name,
-                                funcSig->param_types.empty() ? "<empty>" : params.str(),
-                                funcSig->result_types.empty() ? "<empty>" : results.str(),
-                                func->is_host ? "Yes" : "No",
-                                m_executor->CanBeMain(func) ? "Yes" : "No"});
-            }
-        }
         // Create table header
         std::vector<std::string> header = {"Module", "Func Name", "Func Params", "Func Returns", "Is Host?",
                                            "Can Run?"};
         // Draw table
         int highlightCol = 0;
-        drawTable(topLeftY, topLeftX, numLines, numCols, header, data, header.size(), header.size(), m_funcTopIndex,
-                  m_funcLeftIndex, m_funcHighlight, highlightCol, Highlight::HLINE, true);
+        drawTable(topLeftY, topLeftX, numLines, numCols, header, m_funcData, header.size(), header.size(),
+                  m_funcTopIndex, m_funcLeftIndex, m_funcHighlight, highlightCol, Highlight::HLINE, true);
     }
 
     void ProfilerDisplay::updateDataList() {
+        ScopedFrameSection section("data");
         // Compute list offsets
         int topLeftY = getNumLines() / 2 + 1;
         int topLeftX = 1;
@@ -97,29 +78,178 @@ namespace wdb {
         int numLines = getNumLines() - topLeftY - 2;
         int numCols = getNumCols() - (2 * topLeftX);
 
+        // Prepare data
+        std::string title;
+        std::vector<std::string> header;
+        std::vector<std::vector<std::string>> data;
+        getResultData(title, header, data);
+
         // Draw border
-        drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == RESULTS, "Profiling Result");
+        drawBorder(topLeftY, topLeftX, numLines, numCols, m_focusPanel == RESULTS, title);
 
-        // Prepare data vector
-        std::vector<std::vector<std::string>> data;
-        // Fetch profiler entries
-        auto entries = m_executor->GetProfilerSorted(m_listSort);
-        // Populate data
-        for (int i = 0; i < entries.size(); i++) {
-            auto &currentEntry = entries[i];
-            data.push_back({currentEntry.GetOpcode().GetName(),
-                            std::to_string(currentEntry.GetCount()),
-                            std::to_string(currentEntry.GetTotalTime()),
-                            std::to_string(currentEntry.GetAverageTime())});
-        }
-        // Create table header
-        std::vector<std::string> header = {"Opcode", "Total Count", "Total Time(ns)", "Avg. Time(ns)"};
         // Draw table
         int highlightCol = 0;
         drawTable(topLeftY, topLeftX, numLines, numCols, header, data, header.size(), header.size(), m_dataTopIndex,
                   m_dataLeftIndex, m_dataHighlight, highlightCol, Highlight::HLINE, true);
     }
 
+    void ProfilerDisplay::getResultData(std::string &title, std::vector<std::string> &header,
+                                        std::vector<std::vector<std::string>> &data) {
+        switch (m_resultView) {
+            case VIEW_OPCODES:
+            case VIEW_FUNCTIONS:
+            default: {
+                bool functions = m_resultView == VIEW_FUNCTIONS;
+                title = functions ? "Profiling Result (Functions)" : "Profiling Result";
+                header = {functions ? "Function" : "Opcode", "Total Count", "Total Time(ns)", "Avg. Time(ns)",
+                          "p50(ns)", "p90(ns)", "p99(ns)", "Max(ns)"};
+                auto entries = functions ? m_timingProfile.getFunctionsSorted(m_listSort)
+                                         : m_timingProfile.getOpcodesSorted(m_listSort);
+                for (auto currentEntry : entries) {
+                    data.push_back({currentEntry->name,
+                                    std::to_string(currentEntry->count),
+                                    std::to_string(currentEntry->totalTime),
+                                    std::to_string(currentEntry->getAverageTime()),
+                                    std::to_string(currentEntry->histogram.getPercentile(50)),
+                                    std::to_string(currentEntry->histogram.getPercentile(90)),
+                                    std::to_string(currentEntry->histogram.getPercentile(99)),
+                                    std::to_string(currentEntry->histogram.getMax())});
+                }
+                break;
+            }
+            case VIEW_PAIRS:
+            case VIEW_TRIPLES: {
+                bool pairs = m_resultView == VIEW_PAIRS;
+                title = pairs ? "Profiling Result (Opcode Pairs)" : "Profiling Result (Opcode Triples)";
+                header = {"Sequence", "Count", "Share(%)"};
+                auto sequences = pairs ? m_sequenceProfile.getTopPairs(TOP_SEQUENCES)
+                                       : m_sequenceProfile.getTopTriples(TOP_SEQUENCES);
+                for (auto &sequence : sequences) {
+                    double share = m_sequenceProfile.getTotal() == 0 ? 0
+                            : 100.0 * sequence.count / m_sequenceProfile.getTotal();
+                    data.push_back({sequence.name, std::to_string(sequence.count), std::to_string(share)});
+                }
+                // Too many distinct opcodes for triple counters
+                if(!pairs && m_sequenceProfile.getDroppedTriples() > 0) {
+                    data.push_back({"<not counted>", std::to_string(m_sequenceProfile.getDroppedTriples()), "-"});
+                }
+                break;
+            }
+            case VIEW_MEMORY: {
+                title = "Profiling Result (Memory Pages)";
+                header = {"Memory", "Page Address", "Reads", "Writes", "Read(%)"};
+                for (auto &page : m_memoryProfile.getHottestPages(TOP_PAGES)) {
+                    std::stringstream address;
+                    address << "0x" << std::setfill('0') << std::setw(8) << std::hex
+                            << page.getAddress(MemoryProfile::PAGE_BITS);
+                    double readShare = 100.0 * page.reads / (page.reads + page.writes);
+                    data.push_back({std::to_string(page.memory), address.str(), std::to_string(page.reads),
+                                    std::to_string(page.writes), std::to_string(readShare)});
+                }
+                break;
+            }
+            case VIEW_GROWTH: {
+                // Summarize peak usage in the title
+                std::stringstream ss;
+                ss << "Profiling Result (Memory Growth)";
+                auto &usage = m_growthProfile.getUsage();
+                for (uint32_t i = 0; i < usage.size(); i++) {
+                    ss << " #" << i << " peak:" << usage[i].peakPages << "p touched:" << usage[i].touchedPages
+                       << "p high:" << usage[i].touchedHighWater << "p";
+                }
+                title = ss.str();
+                header = {"Time(ns)", "Instructions", "Function", "Memory", "Pages", "Requested", "Result"};
+                for (auto &event : m_growthProfile.getEvents()) {
+                    data.push_back({std::to_string(event.timestamp), std::to_string(event.instructionCount),
+                                    event.function, std::to_string(event.memory),
+                                    std::to_string(event.previousPages), std::to_string(event.requestedPages),
+                                    event.succeeded() ? std::to_string(event.pages) : "Failed"});
+                }
+                break;
+            }
+            case VIEW_HEAP: {
+                if (!m_heapProfile.isEnabled()) {
+                    title = "Profiling Result (Heap: no allocator hooks found)";
+                } else {
+                    auto &summary = m_heapProfile.getSummary();
+                    title = "Profiling Result (Heap) allocs:" + std::to_string(summary.allocations)
+                            + " frees:" + std::to_string(summary.frees)
+                            + " live:" + std::to_string(summary.liveBytes) + "B"
+                            + " peak:" + std::to_string(summary.peakLiveBytes) + "B";
+                }
+                header = {"Allocation Site", "Allocations", "Bytes", "Live Allocations", "Live Bytes"};
+                for (auto &site : m_heapProfile.getSites()) {
+                    data.push_back({site.name, std::to_string(site.allocations), std::to_string(site.bytes),
+                                    std::to_string(site.liveAllocations), std::to_string(site.liveBytes)});
+                }
+                break;
+            }
+            case VIEW_STACK: {
+                title = "Profiling Result (Stack High-Water)";
+                header = {"Stack", "Maximum", "Function", "Offset"};
+                auto &valueStack = m_stackProfile.getValueStack();
+                auto &callStack = m_stackProfile.getCallStack();
+                data.push_back({"Value stack height", std::to_string(valueStack.value), valueStack.function,
+                                std::to_string(valueStack.offset)});
+                data.push_back({"Call depth", std::to_string(callStack.value), callStack.function,
+                                std::to_string(callStack.offset)});
+                break;
+            }
+            case VIEW_CALLS: {
+                title = "Profiling Result (Call Graph)";
+                header = {"Caller", "Callee", "Calls", "Total Time(ns)", "Avg. Time(ns)"};
+                for (auto &edge : m_callGraphProfile.getEdges()) {
+                    data.push_back({edge.caller, edge.callee, std::to_string(edge.count),
+                                    std::to_string(edge.totalTime),
+                                    std::to_string(edge.count == 0 ? 0 : edge.totalTime / edge.count)});
+                }
+                break;
+            }
+            case VIEW_EXPORTS: {
+                title = "Profiling Result (All Functions) wall:" + std::to_string(m_parallelWallTime) + "ns";
+                header = {"Function", "Result", "Instructions", "Time(ns)", "Wall Time(ns)"};
+                for (auto &run : m_parallelRuns) {
+                    data.push_back({run.function, run.succeeded ? "Ok" : "Failed", std::to_string(run.instructions),
+                                    std::to_string(run.time), std::to_string(run.wallTime)});
+                }
+                break;
+            }
+            case VIEW_DIFF: {
+                header = {"Kind", "Name", "Base Count", "Count", "Base Time(ns)", "Time(ns)", "Delta(ns)",
+                          "Delta(%)"};
+                // Compare two loaded profiles, or the last run against a loaded baseline
+                const ProfileSnapshot *base = nullptr;
+                const ProfileSnapshot *current = nullptr;
+                if (m_loadedProfiles.size() >= 2) {
+                    base = &m_loadedProfiles[0];
+                    current = &m_loadedProfiles[1];
+                } else if (m_loadedProfiles.size() == 1 && m_hasSnapshot) {
+                    base = &m_loadedProfiles[0];
+                    current = &m_snapshot;
+                }
+                if (!base) {
+                    title = "Profiling Result (Diff: load a baseline with --load-profile, then run a function)";
+                    break;
+                }
+                title = "Profiling Result (Diff) " + base->getFunction() + " -> " + current->getFunction();
+                for (auto &delta : ProfileSnapshot::diff(*base, *current)) {
+                    // Name records found in only one profile instead of showing zeros
+                    std::string relative = std::to_string(delta.getRelativeTimeDelta());
+                    if (!delta.inBase) {
+                        relative = "new";
+                    } else if (!delta.inCurrent) {
+                        relative = "removed";
+                    }
+                    data.push_back({delta.category, delta.name, std::to_string(delta.base.count),
+                                    std::to_string(delta.current.count), std::to_string(delta.base.totalTime),
+                                    std::to_string(delta.current.totalTime), std::to_string(delta.getTimeDelta()),
+                                    relative});
+                }
+                break;
+            }
+        }
+    }
+
     void ProfilerDisplay::update() {
         // Erase screen
         werase(m_CDKScreen->window);
@@ -129,7 +259,8 @@ namespace wdb {
             updateDataList();
             // Draw instruction
             setStatus(WDB_COLOR_INFO,
-                      "<ENTER>Run | <TAB>Focus | Sort:<F1>Opcode <F2>Total Count <F3>Total Time <F4>Avg. Time", false);
+                      "<ENTER>Run | <a>Run All | <TAB>Focus | <F5>View | <s>Save | Sort:<F1>Name <F2>Total Count "
+                      "<F3>Total Time <F4>Avg. Time", false);
         } else {
             drawDialog("Error", "Error creating an executor, please verify the wasm file is valid", WDB_COLOR_ERROR,
                        A_BOLD);
@@ -137,23 +268,35 @@ namespace wdb {
     }
 
     void ProfilerDisplay::executeFunction() {
-        if(m_funcHighlight < 0) {
+        if(m_funcHighlight < 0 || m_funcHighlight >= (int) m_moduleIndex->getFunctions().size()) {
             setStatus(WDB_COLOR_ERROR, "No function is selected", true);
         } else {
             // Get highlighted function
-            auto entryExport = m_funcList[m_funcHighlight];
-            auto func = m_executor->GetFunction(entryExport.index);
-            if(!m_executor->CanBeMain(func)) {
+            auto entryExport = m_moduleIndex->getFunctions()[m_funcHighlight];
+            if(!entryExport.canRun) {
                 setStatus(WDB_COLOR_ERROR, "Selected function cannot be executed", true);
             } else {
                 setStatus(WDB_COLOR_INFO, "Running function ...", false);
                 draw();
                 // Set new executor
-                m_executor = m_wdbWabt->CreateWdbProfilerExecutor(m_executorOptions);
+                m_executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_executorOptions);
+                auto func = m_executor->GetFunction(entryExport.index);
+                // Clear previous results
+                resetResults();
                 // Set main function
                 if(m_executor->SetMainFunction(func) == wabt::Result::Ok) {
-                    // Execute function
-                    if(m_executor->Execute() == wabt::Result::Ok){
+                    // Trace function
+                    wdb::Tracer tracer(m_executor, m_moduleIndex);
+                    tracer.addListener(&m_timingProfile);
+                    tracer.addListener(&m_sequenceProfile);
+                    tracer.addListener(&m_memoryProfile);
+                    tracer.addListener(&m_growthProfile);
+                    tracer.addListener(&m_heapProfile);
+                    tracer.addListener(&m_stackProfile);
+                    tracer.addListener(&m_callGraphProfile);
+                    if(tracer.run() == wabt::Result::Ok){
+                        m_snapshot.capture(entryExport.name, tracer, m_timingProfile, m_callGraphProfile);
+                        m_hasSnapshot = true;
                         setStatus(WDB_COLOR_SUCCESS, "Function finished executing, press any key to see results", true);
                     } else {
                         setStatus(WDB_COLOR_ERROR, "Error executing function", true);
@@ -165,13 +308,61 @@ namespace wdb {
         }
     }
 
+    void ProfilerDisplay::resetResults() {
+        m_timingProfile.reset();
+        m_sequenceProfile.reset();
+        m_memoryProfile.reset();
+        m_growthProfile.reset();
+        m_heapProfile.reset();
+        m_stackProfile.reset();
+        m_callGraphProfile.reset();
+        m_hasSnapshot = false;
+        m_parallelRuns.clear();
+        m_parallelWallTime = 0;
+    }
+
+    void ProfilerDisplay::executeAllFunctions() {
+        ParallelProfiler profiler(m_wdbWabt, m_executorOptions);
+        // Already indexed, no executor is created
+        auto functions = m_moduleIndex->getRunnableNames();
+        if(functions.empty()) {
+            setStatus(WDB_COLOR_ERROR, "No runnable function without parameters", true);
+            return;
+        }
+        setStatus(WDB_COLOR_INFO, "Running " + std::to_string(functions.size()) + " functions on "
+                                  + std::to_string(profiler.getThreadCount()) + " threads ...", false);
+        draw();
+        resetResults();
+        profiler.run(functions);
+        // Show merged results
+        m_timingProfile = profiler.getProfile();
+        m_parallelRuns = profiler.getRuns();
+        m_parallelWallTime = profiler.getWallTime();
+        m_resultView = VIEW_EXPORTS;
+        m_dataHighlight = 0;
+        setStatus(WDB_COLOR_SUCCESS, "All functions finished executing, press any key to see results", true);
+    }
+
+    void ProfilerDisplay::saveSnapshot() {
+        if(!m_hasSnapshot) {
+            setStatus(WDB_COLOR_ERROR, "Run a function before saving its profile", true);
+            return;
+        }
+        std::string fileName = m_snapshot.getFunction() + ".prof";
+        if(m_snapshot.save(fileName)) {
+            setStatus(WDB_COLOR_SUCCESS, "Profile saved to " + fileName, true);
+        } else {
+            setStatus(WDB_COLOR_ERROR, "Error writing " + fileName, true);
+        }
+    }
+
     void ProfilerDisplay::listen() {
         // Update and draw screen
         update();
         draw();
         // Listen for keyboard input
         while(m_executor) {
-            int c = wgetch(m_CDKScreen->window);
+            int c = getInput();
             switch (c) {
                 case 'q':
                 case KEY_ESC:
@@ -207,6 +398,16 @@ namespace wdb {
                         m_listSort = wdb::WdbProfilerExecutor::Sort::AVG_TIME_ASC;
                     }
                     break;
+                case KEY_F(5):
+                    m_resultView = static_cast<ResultView>((m_resultView+1) % VIEW_COUNT);
+                    m_dataHighlight = 0;
+                    break;
+                case 's':
+                    saveSnapshot();
+                    break;
+                case 'a':
+                    executeAllFunctions();
+                    break;
                 case KEY_UP:
                     if(m_focusPanel == FUNCTIONS) {
                         m_funcHighlight--;
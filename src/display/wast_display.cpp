@@ -1,12 +1,16 @@
 #include <wdb_tui/wast_display.h>
 #include <wdb_tui/common.h>
+#include <wdb_tui/timings.h>
+#include <wdb_tui/frame_stats.h>
 #include <sstream>
 #include <vector>
 
 namespace wdb {
     WastDisplay::WastDisplay(wdb::WdbWabt *wdbWabt) : Display(DISPLAYS_LINES, DISPLAYS_COLS, 0, SIDE_MENU_COLS) {
+        ScopedTimer timer("wast display");
         // Enable keypad
         keypad(m_CDKScreen->window, true);
+        m_frameName = "wast";
         // Create a code generator
         m_codeGen = wdbWabt->CreateCodeGenerator();
     }
@@ -22,16 +26,40 @@ namespace wdb {
         }
     }
 
-    void WastDisplay::update() {
-        // Erase screen
-        werase(m_CDKScreen->window);
+    void WastDisplay::setCache(wdb::ModuleCache *cache, const std::string &key) {
+        m_cache = cache;
+        m_cacheKey = key;
+    }
 
+    void WastDisplay::generateWast() {
+        if(m_wastGenerated) {
+            return;
+        }
+        m_wastGenerated = true;
+        std::string wast;
+        if(m_cache && m_cache->loadText(m_cacheKey, "wat", wast)) {
+            setWast(wast);
+            return;
+        }
         // Set wast code
         wabt::WriteWatOptions options;
         options.fold_exprs = true;
         options.inline_export = true;
         options.inline_import = true;
-        setWast(m_codeGen->GetWat(options));
+        wast = m_codeGen->GetWat(options);
+        setWast(wast);
+        if(m_cache) {
+            m_cache->saveText(m_cacheKey, "wat", wast);
+        }
+    }
+
+    void WastDisplay::update() {
+        ScopedFrameSection section("code");
+        // Erase screen
+        werase(m_CDKScreen->window);
+
+        // The module does not change, generate its code once
+        generateWast();
 
         // Update code view configuration
         m_codeNumLines = getNumLines() - 2;
@@ -51,7 +79,7 @@ namespace wdb {
         while(true) {
             update();
             draw();
-            int c = wgetch(m_CDKScreen->window);
+            int c = getInput();
             switch (c) {
                 case 'q':
                 case KEY_ESC:
@@ -4,11 +4,40 @@
 #include <wdb_tui/wast_display.h>
 #include <wdb_tui/profiler_display.h>
 #include <wdb_tui/debug_display.h>
+#include <wdb_tui/debug_session.h>
+#include <wdb_tui/gdb_server.h>
+#include <wdb_tui/dap_server.h>
 #include <wdb_tui/host_functions.h>
+#include <wdb_tui/tracer.h>
+#include <wdb_tui/timing_profile.h>
+#include <wdb_tui/sequence_profile.h>
+#include <wdb_tui/coverage_profile.h>
+#include <wdb_tui/memory_profile.h>
+#include <wdb_tui/growth_profile.h>
+#include <wdb_tui/heap_profile.h>
+#include <wdb_tui/stack_profile.h>
+#include <wdb_tui/benchmark.h>
+#include <wdb_tui/call_graph_profile.h>
+#include <wdb_tui/profile_snapshot.h>
+#include <wdb_tui/parallel_profiler.h>
+#include <wdb_tui/thread_pool.h>
+#include <wdb_tui/mapped_file.h>
+#include <wdb_tui/timings.h>
+#include <wdb_tui/frame_stats.h>
+#include <wdb_tui/module_cache.h>
+#include <wdb_tui/module_index.h>
 #include <vector>
+#include <memory>
+#include <functional>
 #include <chrono>
+#include <cerrno>
+#include <climits>
 #include <iostream>
 #include <fstream>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
 
 // Program arguments
 std::vector<std::string> inputFiles;
@@ -16,6 +45,34 @@ std::string f_arg_function;
 bool f_profiler = false;
 bool f_tuiEnabled = false;
 bool f_initHostFunctions = false;
+int f_topSequences = 10;
+std::string f_coverageFile;
+std::string f_memoryProfileFile;
+bool f_memoryLines = false;
+std::string f_growthTimelineFile;
+wdb::HeapProfile::Hooks f_heapHooks;
+std::string f_heapReportFile;
+int f_callDepthLimit = 0;
+bool f_stackProfile = false;
+bool f_benchmark = false;
+int f_warmupIterations = 3;
+int f_benchIterations = 10;
+std::string f_benchOutputFile;
+std::string f_saveProfileFile;
+std::vector<std::string> f_loadProfileFiles;
+std::string f_compareFile;
+double f_compareThreshold = 5;
+bool f_allowMissing = false;
+bool f_profileAll = false;
+int f_jobs = 0;
+bool f_timings = false;
+bool f_cache = true;
+bool f_uiStats = false;
+std::string f_consoleLogFile;
+std::string f_scriptFile;
+std::vector<std::string> f_scriptCommands;
+std::string f_gdbAddress;
+bool f_dap = false;
 
 /**
  * Print usage message
@@ -24,32 +81,113 @@ void printUsage() {
     std::cerr
             << "wdb_tui - Debug wasm on the terminal" << std::endl
             << "Usage: wdb [OPTION]... [FILE]..." << std::endl
-            << "    -t, --tui               Open in tui mode" << std::endl
-            << "    -i, --init-host         Initialize host functions" << std::endl
-            << "    -r, --run      <func>   Execute an exported function" << std::endl
-            << "    -p, --profiler <func>   Show profiler info for an exported function" << std::endl
-            << "    -h, --help              Display this help message" << std::endl;
+            << "    -t, --tui                   Open in tui mode" << std::endl
+            << "    -i, --init-host             Initialize host functions" << std::endl
+            << "    -r, --run <func>            Execute an exported function" << std::endl
+            << "    -p, --profiler <func>       Show profiler info for an exported function" << std::endl
+            << "    -P, --profile-all           Profile every exported function without parameters in parallel" << std::endl
+            << "    -j, --jobs <n>              Threads for --profile-all and several files (default: cores)" << std::endl
+            << "    -k, --top <n>               Number of entries in profiler top lists (default: 10)" << std::endl
+            << "    -m, --mem-profile <file>    Write memory accesses per page when profiling" << std::endl
+            << "    -l, --mem-lines             Also count memory accesses per 64-byte line" << std::endl
+            << "    -g, --grow-timeline <file>  Write memory growth events as CSV when profiling" << std::endl
+            << "    -a, --alloc-hooks <spec>    Track allocations made by the module's allocator functions" << std::endl
+            << "                                <spec>: malloc=<func>,free=<func>[,calloc=<func>][,realloc=<func>]"
+            << std::endl
+            << "                                <func>: export name or #<function index, imports counted>" << std::endl
+            << "    -A, --alloc-report <file>   Write allocation sites and leaks when profiling" << std::endl
+            << "    -H, --stack-profile         Report value stack and call depth high-water marks when profiling"
+            << std::endl
+            << "    -d, --max-depth <n>         Stop profiling when the call depth exceeds n" << std::endl
+            << "    -s, --save-profile <file>   Save profiler results to a file" << std::endl
+            << "    -L, --load-profile <file>   Compare with a saved profile in tui mode" << std::endl
+            << "                                Given twice, compare the two profiles" << std::endl
+            << "    -C, --compare <file>        Run a function and fail on regressions against a saved profile" << std::endl
+            << "    -T, --threshold <n>%        Allowed increase of instructions and time when comparing (default: 5%)"
+            << std::endl
+            << "    -M, --allow-missing         Do not fail on baseline functions that did not run" << std::endl
+            << "    -b, --bench <func>          Benchmark an exported function over repeated runs" << std::endl
+            << "    -w, --warmup <n>            Number of unmeasured benchmark runs (default: 3)" << std::endl
+            << "    -n, --iterations <n>        Number of measured benchmark runs (default: 10)" << std::endl
+            << "    -o, --bench-output <file>   Write benchmark results as JSON" << std::endl
+            << "    -c, --coverage <file>       Merge coverage of the executed function into an lcov file" << std::endl
+            << "    -x, --timings               Print time spent in each startup phase" << std::endl
+            << "    -z, --no-cache              Do not use the module cache in $XDG_CACHE_HOME/wdb_tui" << std::endl
+            << "    -S, --script <file>         Run debugger commands from a file, '-' for stdin, without the tui"
+            << std::endl
+            << "    -G, --gdb-server <address>  Serve a GDB remote stub on unix:<path> or localhost:<port>" << std::endl
+            << "    -D, --dap                   Speak the Debug Adapter Protocol on stdin and stdout" << std::endl
+            << "    -O, --console-log <file>    Append all console lines to a file" << std::endl
+            << "    -u, --ui-stats              Show frame times in tui mode and print them on exit (toggle: F12)"
+            << std::endl
+            << "    -h, --help                  Display this help message" << std::endl;
+}
+
+/**
+ * Parse a whole number option value
+ * @param text
+ * @param minimum
+ * @param value
+ * @return false if the text is not a number in [minimum, INT_MAX]
+ */
+bool parseInt(const char *text, int minimum, int &value) {
+    char *end = nullptr;
+    errno = 0;
+    long parsed = std::strtol(text, &end, 10);
+    if(end == text || *end != '\0' || errno == ERANGE || parsed < minimum || parsed > INT_MAX) {
+        return false;
+    }
+    value = (int) parsed;
+    return true;
 }
 
 /**
  * Initialize parameter
  * @param argc
  * @param argv
+ * @return false if an option value is invalid
  */
-void initParams(int argc, char *argv[]) {
+bool initParams(int argc, char *argv[]) {
 
     struct option longOptions[] = {
             {"tui", no_argument, 0, 't'},
             {"init-host", no_argument, 0, 'i'},
             {"run", required_argument, 0, 'r'},
             {"profiler", required_argument, 0, 'p'},
+            {"profile-all", no_argument, 0, 'P'},
+            {"jobs", required_argument, 0, 'j'},
+            {"top", required_argument, 0, 'k'},
+            {"coverage", required_argument, 0, 'c'},
+            {"mem-profile", required_argument, 0, 'm'},
+            {"mem-lines", no_argument, 0, 'l'},
+            {"grow-timeline", required_argument, 0, 'g'},
+            {"alloc-hooks", required_argument, 0, 'a'},
+            {"alloc-report", required_argument, 0, 'A'},
+            {"stack-profile", no_argument, 0, 'H'},
+            {"max-depth", required_argument, 0, 'd'},
+            {"save-profile", required_argument, 0, 's'},
+            {"load-profile", required_argument, 0, 'L'},
+            {"compare", required_argument, 0, 'C'},
+            {"threshold", required_argument, 0, 'T'},
+            {"allow-missing", no_argument, 0, 'M'},
+            {"bench", required_argument, 0, 'b'},
+            {"warmup", required_argument, 0, 'w'},
+            {"iterations", required_argument, 0, 'n'},
+            {"bench-output", required_argument, 0, 'o'},
+            {"timings", no_argument, 0, 'x'},
+            {"no-cache", no_argument, 0, 'z'},
+            {"ui-stats", no_argument, 0, 'u'},
+            {"console-log", required_argument, 0, 'O'},
+            {"script", required_argument, 0, 'S'},
+            {"gdb-server", required_argument, 0, 'G'},
+            {"dap", no_argument, 0, 'D'},
             {"help", no_argument, 0, 'h'},
             {0, 0,                0, 0}
     };
 
     int optionIndex = 0;
     int c;
-    while ((c = getopt_long(argc, argv, "tir:p:h", longOptions, &optionIndex)) != -1) {
+    while ((c = getopt_long(argc, argv, "tir:p:Pj:k:c:m:lg:a:A:Hd:s:L:C:T:Mb:w:n:o:xzuO:S:G:Dh", longOptions, &optionIndex)) != -1) {
         switch (c) {
             case 't':
                 f_tuiEnabled = true;
@@ -64,12 +202,117 @@ void initParams(int argc, char *argv[]) {
             case 'r':
                 f_arg_function = optarg;
                 break;
+            case 'P':
+                f_profileAll = true;
+                break;
+            case 'j':
+                if(!parseInt(optarg, 1, f_jobs)) {
+                    std::cerr << "Invalid job count: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            case 'k':
+                if(!parseInt(optarg, 1, f_topSequences)) {
+                    std::cerr << "Invalid top count: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            case 'c':
+                f_coverageFile = optarg;
+                break;
+            case 'm':
+                f_memoryProfileFile = optarg;
+                break;
+            case 'l':
+                f_memoryLines = true;
+                break;
+            case 'g':
+                f_growthTimelineFile = optarg;
+                break;
+            case 'a':
+                if(!wdb::HeapProfile::parseHooks(optarg, f_heapHooks)) {
+                    std::cerr << "Invalid allocator hooks: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            case 'A':
+                f_heapReportFile = optarg;
+                break;
+            case 'H':
+                f_stackProfile = true;
+                break;
+            case 'd':
+                f_callDepthLimit = std::atoi(optarg);
+                break;
+            case 's':
+                f_saveProfileFile = optarg;
+                break;
+            case 'L':
+                f_loadProfileFiles.push_back(optarg);
+                break;
+            case 'C':
+                f_compareFile = optarg;
+                break;
+            case 'T': {
+                // Accept both "5" and "5%"
+                char *end = nullptr;
+                f_compareThreshold = std::strtod(optarg, &end);
+                if(end == optarg || (*end != '\0' && std::string(end) != "%") || f_compareThreshold < 0) {
+                    std::cerr << "Invalid threshold: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            }
+            case 'M':
+                f_allowMissing = true;
+                break;
+            case 'b':
+                f_benchmark = true;
+                f_arg_function = optarg;
+                break;
+            case 'w':
+                if(!parseInt(optarg, 0, f_warmupIterations)) {
+                    std::cerr << "Invalid warmup count: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            case 'n':
+                if(!parseInt(optarg, 1, f_benchIterations)) {
+                    std::cerr << "Invalid iteration count: " << optarg << std::endl;
+                    return false;
+                }
+                break;
+            case 'o':
+                f_benchOutputFile = optarg;
+                break;
+            case 'x':
+                f_timings = true;
+                break;
+            case 'z':
+                f_cache = false;
+                break;
+            case 'u':
+                f_uiStats = true;
+                break;
+            case 'O':
+                f_consoleLogFile = optarg;
+                break;
+            case 'S':
+                f_scriptFile = optarg;
+                break;
+            case 'G':
+                f_gdbAddress = optarg;
+                break;
+            case 'D':
+                f_dap = true;
+                break;
             case 'h':
             default:
                 // Print by default
                 break;
         }
     }
+    return true;
 }
 
 void initColors() {
@@ -81,6 +324,10 @@ void initColors() {
     init_pair(WDB_COLOR_SUCCESS, COLOR_WHITE, COLOR_GREEN);
     init_pair(WDB_COLOR_ERROR, COLOR_WHITE, COLOR_RED);
     init_pair(WDB_COLOR_INFO, COLOR_WHITE, COLOR_CYAN);
+    init_pair(WDB_COLOR_HEAT_1, COLOR_BLUE, COLOR_BLACK);
+    init_pair(WDB_COLOR_HEAT_2, COLOR_CYAN, COLOR_BLACK);
+    init_pair(WDB_COLOR_HEAT_3, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(WDB_COLOR_HEAT_4, COLOR_RED, COLOR_BLACK);
 }
 
 /**
@@ -110,20 +357,49 @@ void endNCurses() {
     endCDK();
 }
 
-void tui(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options &options) {
+bool tui(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options &options, wdb::ModuleIndex &moduleIndex,
+         wdb::ModuleCache *cache, const std::string &cacheKey) {
+    // Read saved profiles before the terminal is taken over
+    std::vector<wdb::ProfileSnapshot> loadedProfiles;
+    for(auto &profileFile : f_loadProfileFiles) {
+        wdb::ProfileSnapshot snapshot;
+        std::string error;
+        if(!snapshot.load(profileFile, error)) {
+            std::cerr << error << std::endl;
+            return false;
+        }
+        loadedProfiles.push_back(snapshot);
+    }
     // Init NCurses
-    initNCurses();
-    // Init displays
+    {
+        wdb::ScopedTimer timer("init ncurses");
+        initNCurses();
+    }
+    // Record frame times from the first input
+    if(f_uiStats) {
+        wdb::FrameStats::get().toggleOverlay();
+    }
+    // Init displays, the others are created on first selection
     wdb::SideMenu sideMenu;
     wdb::HomeDisplay homeDisplay;
-    wdb::WastDisplay wastDisplay(&wdbWabt);
-    wdb::ProfilerDisplay profilerDisplay(&wdbWabt, options);
-    wdb::DebugDisplay debugDisplay(&wdbWabt, options);
+    std::unique_ptr<wdb::WastDisplay> wastDisplay;
+    std::unique_ptr<wdb::ProfilerDisplay> profilerDisplay;
+    std::unique_ptr<wdb::DebugDisplay> debugDisplay;
+    // Startup is over, deferred display construction is still recorded
+    wdb::Timings::get().stop();
+    auto recordPhase = [](const std::function<void()> &phase) {
+        wdb::Timings::get().resume();
+        phase();
+        wdb::Timings::get().stop();
+    };
 
     // Draw side menu
     sideMenu.draw();
     // By default display home
     homeDisplay.draw();
+    if(f_timings) {
+        homeDisplay.setStatus(wdb::Timings::get().getSummary());
+    }
 
     // Listen for menu events
     wdb::SideMenu::MENU_ITEM selectedDisplay;
@@ -134,31 +410,61 @@ void tui(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options &options) {
                 homeDisplay.draw();
                 break;
             case wdb::SideMenu::MENU_ITEM::WAST:
-                wastDisplay.setFocus(true);
-                wastDisplay.listen();
-                wastDisplay.setFocus(false);
-                wastDisplay.draw();
+                if(!wastDisplay) {
+                    recordPhase([&]() {
+                        wastDisplay.reset(new wdb::WastDisplay(&wdbWabt));
+                    });
+                    if(cache) {
+                        wastDisplay->setCache(cache, cacheKey);
+                    }
+                }
+                wastDisplay->setFocus(true);
+                wastDisplay->listen();
+                wastDisplay->setFocus(false);
+                wastDisplay->draw();
                 break;
             case wdb::SideMenu::MENU_ITEM::PROFILER:
-                profilerDisplay.setFocus(true);
-                profilerDisplay.listen();
-                profilerDisplay.setFocus(false);
-                profilerDisplay.draw();
+                if(!profilerDisplay) {
+                    recordPhase([&]() {
+                        profilerDisplay.reset(new wdb::ProfilerDisplay(&wdbWabt, options, f_heapHooks, &moduleIndex));
+                    });
+                    for(auto &snapshot : loadedProfiles) {
+                        profilerDisplay->addProfile(snapshot);
+                    }
+                }
+                profilerDisplay->setFocus(true);
+                profilerDisplay->listen();
+                profilerDisplay->setFocus(false);
+                profilerDisplay->draw();
                 break;
             case wdb::SideMenu::MENU_ITEM::DEBUG:
-                debugDisplay.setFocus(true);
-                debugDisplay.listen();
-                debugDisplay.setFocus(false);
-                debugDisplay.draw();
+                if(!debugDisplay) {
+                    recordPhase([&]() {
+                        debugDisplay.reset(new wdb::DebugDisplay(&wdbWabt, options, &moduleIndex));
+                    });
+                    if(!f_consoleLogFile.empty()) {
+                        debugDisplay->setConsoleSpillFile(f_consoleLogFile);
+                    }
+                }
+                debugDisplay->setFocus(true);
+                debugDisplay->listen();
+                debugDisplay->setFocus(false);
+                debugDisplay->draw();
                 break;
         }
     }
 
     // Destroy ncurses
     endNCurses();
+    // Print frame times once the terminal is restored
+    if(wdb::FrameStats::get().isEnabled()) {
+        wdb::FrameStats::get().print(std::cerr);
+    }
+    return true;
 }
 
 void InitHostFunctions(wdb::WdbExecutor* executor) {
+    wdb::ScopedTimer timer("host functions");
     if(f_initHostFunctions) {
         std::string moduleName = "wdb_tui";
         // Print function
@@ -203,32 +509,645 @@ void InitHostFunctions(wdb::WdbExecutor* executor) {
     wdb_stubs::InitHostFunctions(executor);
 }
 
-wabt::Result Execute(wdb::WdbExecutor* executor) {
-    wabt::Result result;
+wabt::Result SetMainFunction(wdb::WdbExecutor* executor, std::ostream &err = std::cerr) {
     wabt::interp::Export* eFunction;
-    result = executor->SearchExportedModuleFunction(executor->GetMainModule(), f_arg_function, &eFunction);
-    if(result == wabt::Result::Ok) {
-        wabt::interp::Func* func = executor->GetFunction(eFunction->index);
-        result = executor->SetMainFunction(func);
-        if(result == wabt::Result::Ok) {
-            result = executor->Execute();
-            if(result == wabt::Result::Ok) {
-                return wabt::Result::Ok;
-            } else {
-                std::cerr << "Error executing '" << f_arg_function << "'" << std::endl;
+    if(executor->SearchExportedModuleFunction(executor->GetMainModule(), f_arg_function, &eFunction)
+       != wabt::Result::Ok) {
+        err << "Function '" << f_arg_function << "' was not found!" << std::endl;
+        return wabt::Result::Error;
+    }
+    wabt::interp::Func* func = executor->GetFunction(eFunction->index);
+    if(executor->SetMainFunction(func) != wabt::Result::Ok) {
+        err << "Error setting '" << f_arg_function << "' as main function" << std::endl;
+        return wabt::Result::Error;
+    }
+    return wabt::Result::Ok;
+}
+
+wabt::Result Execute(wdb::WdbExecutor* executor, std::ostream &err = std::cerr) {
+    if(SetMainFunction(executor, err) == wabt::Result::Ok) {
+        if(executor->Execute() == wabt::Result::Ok) {
+            return wabt::Result::Ok;
+        }
+        err << "Error executing '" << f_arg_function << "'" << std::endl;
+    }
+    return wabt::Result::Error;
+}
+
+/**
+ * Print profiler entries
+ * @param entries
+ * @param out
+ */
+void PrintProfilerEntries(const std::vector<const wdb::TimingProfile::Entry*> &entries,
+                          std::ostream &out = std::cout) {
+    for(auto entry : entries) {
+        out << "  " << entry->name << std::endl
+            << "  ├ Count:      " << entry->count << std::endl
+            << "  ├ Total Time: " << entry->totalTime << " ns" << std::endl
+            << "  ├ Avg. Time:  " << entry->getAverageTime() << " ns" << std::endl
+            << "  ├ p50/p90/p99: " << entry->histogram.getPercentile(50) << "/"
+            << entry->histogram.getPercentile(90) << "/"
+            << entry->histogram.getPercentile(99) << " ns" << std::endl
+            << "  └ Max Time:   " << entry->histogram.getMax() << " ns" << std::endl;
+    }
+}
+
+/**
+ * Print opcode sequences
+ * @param sequences
+ * @param out
+ */
+void PrintSequences(const std::vector<wdb::SequenceProfile::Sequence> &sequences,
+                    std::ostream &out = std::cout) {
+    for(auto &sequence : sequences) {
+        out << "  " << sequence.count << "\t" << sequence.name << std::endl;
+    }
+}
+
+wabt::Result Profile(wdb::WdbDebuggerExecutor* executor, wdb::ModuleIndex &moduleIndex, std::ostream &out = std::cout,
+                     std::ostream &err = std::cerr) {
+    if(SetMainFunction(executor, err) != wabt::Result::Ok) {
+        return wabt::Result::Error;
+    }
+    wdb::Tracer tracer(executor, &moduleIndex);
+    wdb::TimingProfile timingProfile;
+    wdb::SequenceProfile sequenceProfile;
+    wdb::MemoryProfile memoryProfile(f_memoryLines);
+    wdb::GrowthProfile growthProfile;
+    wdb::HeapProfile heapProfile(f_heapHooks);
+    wdb::StackProfile stackProfile(f_callDepthLimit);
+    wdb::CallGraphProfile callGraphProfile;
+    tracer.addListener(&timingProfile);
+    tracer.addListener(&sequenceProfile);
+    tracer.addListener(&callGraphProfile);
+    // Memory growth is part of every profile, -g only adds the timeline file
+    tracer.addListener(&growthProfile);
+    // Optional profiles add work to every instruction, attach only those requested
+    bool memoryRequested = !f_memoryProfileFile.empty() || f_memoryLines;
+    bool stackRequested = f_stackProfile || f_callDepthLimit > 0;
+    if(memoryRequested) {
+        tracer.addListener(&memoryProfile);
+    }
+    if(!f_heapHooks.empty()) {
+        tracer.addListener(&heapProfile);
+    }
+    if(stackRequested) {
+        tracer.addListener(&stackProfile);
+    }
+    if(tracer.run() != wabt::Result::Ok) {
+        if(stackRequested && stackProfile.limitReached()) {
+            err << "Call depth exceeded " << f_callDepthLimit << " in '"
+                << stackProfile.getCallStack().function << "'" << std::endl;
+        } else {
+            err << "Error executing '" << f_arg_function << "'" << std::endl;
+        }
+        return wabt::Result::Error;
+    }
+    // Results are printed even if an output file cannot be written
+    wabt::Result result = wabt::Result::Ok;
+    out << "[Profiler results]" << std::endl;
+    PrintProfilerEntries(timingProfile.getOpcodesSorted(wdb::WdbProfilerExecutor::Sort::OPCODE_ASC), out);
+    out << "[Function results]" << std::endl;
+    PrintProfilerEntries(timingProfile.getFunctionsSorted(wdb::WdbProfilerExecutor::Sort::TOTAL_TIME_DESC), out);
+    out << "[Opcode pairs]" << std::endl;
+    PrintSequences(sequenceProfile.getTopPairs(f_topSequences), out);
+    out << "[Opcode triples]" << std::endl;
+    if(sequenceProfile.hasTriples()) {
+        PrintSequences(sequenceProfile.getTopTriples(f_topSequences), out);
+    } else if(sequenceProfile.getDroppedTriples() > 0) {
+        out << "  " << sequenceProfile.getDroppedTriples() << " triples not counted, the module uses more than "
+            << wdb::SequenceProfile::MAX_TRIPLE_OPCODES << " distinct opcodes" << std::endl;
+    }
+    out << "[Call graph]" << std::endl;
+    auto edges = callGraphProfile.getEdges();
+    for(int i=0; i < edges.size() && i < f_topSequences; i++) {
+        out << "  " << edges[i].caller << " -> " << edges[i].callee << ": " << edges[i].count << " calls, "
+            << edges[i].totalTime << " ns" << std::endl;
+    }
+    if(stackRequested) {
+        out << "[Stack]" << std::endl
+            << "  Value Stack Height: " << stackProfile.getValueStack().value << " in '"
+            << stackProfile.getValueStack().function << "' at " << stackProfile.getValueStack().offset << std::endl
+            << "  Call Depth:         " << stackProfile.getCallStack().value << " in '"
+            << stackProfile.getCallStack().function << "' at " << stackProfile.getCallStack().offset << std::endl;
+    }
+    if(memoryRequested) {
+        out << "[Memory pages]" << std::endl;
+        for(auto &page : memoryProfile.getHottestPages(f_topSequences)) {
+            out << "  #" << page.memory << " 0x" << std::setfill('0') << std::setw(8) << std::hex
+                << page.getAddress(wdb::MemoryProfile::PAGE_BITS) << std::dec << std::setfill(' ')
+                << "  reads: " << page.reads << "  writes: " << page.writes << std::endl;
+        }
+        if(!f_memoryProfileFile.empty() && !memoryProfile.save(f_memoryProfileFile)) {
+            err << "Error writing memory profile: " << f_memoryProfileFile << std::endl;
+            result = wabt::Result::Error;
+        }
+    }
+    out << "[Memory growth]" << std::endl;
+    for(uint32_t i=0; i < growthProfile.getUsage().size(); i++) {
+        auto &usage = growthProfile.getUsage()[i];
+        out << "  #" << i << std::endl
+            << "  ├ Initial Pages: " << usage.initialPages << std::endl
+            << "  ├ Peak Pages:    " << usage.peakPages << std::endl
+            << "  ├ Touched Pages: " << usage.touchedPages << std::endl
+            << "  └ Touched High:  " << usage.touchedHighWater << std::endl;
+    }
+    for(auto &event : growthProfile.getEvents()) {
+        out << "  " << event.timestamp << " ns, " << event.instructionCount << " instructions, "
+            << event.function << ": #" << event.memory << " " << event.previousPages << " + "
+            << event.requestedPages << " pages -> "
+            << (event.succeeded() ? std::to_string(event.pages) : "failed") << std::endl;
+    }
+    if(!f_growthTimelineFile.empty() && !growthProfile.save(f_growthTimelineFile)) {
+        err << "Error writing memory growth timeline: " << f_growthTimelineFile << std::endl;
+        result = wabt::Result::Error;
+    }
+    if(!f_heapHooks.empty()) {
+        auto &summary = heapProfile.getSummary();
+        out << "[Heap]" << std::endl;
+        if(!heapProfile.isEnabled()) {
+            out << "  No allocator hooks found in module" << std::endl;
+        } else {
+            out << "  Allocations:     " << summary.allocations << std::endl
+                << "  Frees:           " << summary.frees << std::endl
+                << "  Bytes:           " << summary.bytes << std::endl
+                << "  Peak Live Bytes: " << summary.peakLiveBytes << std::endl
+                << "  Invalid Frees:   " << summary.invalidFrees << std::endl
+                << "  Leaks:           " << summary.liveAllocations << " (" << summary.liveBytes << " bytes)"
+                << std::endl;
+            auto sites = heapProfile.getSites();
+            for(int i=0; i < sites.size() && i < f_topSequences; i++) {
+                out << "  " << sites[i].name << std::endl
+                    << "  ├ Allocations: " << sites[i].allocations << " (" << sites[i].bytes << " bytes)"
+                    << std::endl
+                    << "  └ Live:        " << sites[i].liveAllocations << " (" << sites[i].liveBytes
+                    << " bytes)" << std::endl;
             }
+        }
+        if(!f_heapReportFile.empty() && !heapProfile.save(f_heapReportFile)) {
+            err << "Error writing allocation report: " << f_heapReportFile << std::endl;
+            result = wabt::Result::Error;
+        }
+    }
+    out << "[End of results]" << std::endl;
+    if(!f_saveProfileFile.empty()) {
+        wdb::ProfileSnapshot snapshot;
+        snapshot.capture(f_arg_function, tracer, timingProfile, callGraphProfile);
+        if(!snapshot.save(f_saveProfileFile)) {
+            err << "Error writing profile: " << f_saveProfileFile << std::endl;
+            result = wabt::Result::Error;
+        }
+    }
+    return result;
+}
+
+wabt::Result ProfileAll(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options options, wdb::ModuleIndex &moduleIndex) {
+    wdb::ParallelProfiler profiler(&wdbWabt, options, f_jobs, &moduleIndex);
+    auto functions = profiler.getRunnableFunctions();
+    if(functions.empty()) {
+        std::cerr << "No runnable function without parameters was found!" << std::endl;
+        return wabt::Result::Error;
+    }
+    // Workers set up their own executors, phases on other threads would interleave
+    wdb::Timings::get().stop();
+    profiler.run(functions);
+    std::cout << "[Parallel results]" << std::endl
+              << "  Functions: " << functions.size() << std::endl
+              << "  Threads:   " << std::min(profiler.getThreadCount(), (int) functions.size()) << std::endl
+              << "  Wall Time: " << profiler.getWallTime() << " ns" << std::endl;
+    bool succeeded = true;
+    for(auto &run : profiler.getRuns()) {
+        succeeded &= run.succeeded;
+        std::cout << "  " << run.function << (run.succeeded ? "" : " (failed)") << std::endl
+                  << "  ├ Instructions:  " << run.instructions << std::endl
+                  << "  ├ Time:          " << run.time << " ns" << std::endl
+                  << "  └ Wall Time:     " << run.wallTime << " ns" << std::endl;
+    }
+    std::cout << "[Profiler results]" << std::endl;
+    PrintProfilerEntries(profiler.getProfile().getOpcodesSorted(wdb::WdbProfilerExecutor::Sort::OPCODE_ASC));
+    std::cout << "[Function results]" << std::endl;
+    PrintProfilerEntries(profiler.getProfile().getFunctionsSorted(wdb::WdbProfilerExecutor::Sort::TOTAL_TIME_DESC));
+    std::cout << "[End of results]" << std::endl;
+    return succeeded ? wabt::Result::Ok : wabt::Result::Error;
+}
+
+wabt::Result Compare(wdb::WdbDebuggerExecutor* executor, wdb::ModuleIndex &moduleIndex) {
+    // Fail early on a bad baseline
+    wdb::ProfileSnapshot baseline;
+    std::string error;
+    if(!baseline.load(f_compareFile, error)) {
+        std::cerr << error << std::endl;
+        return wabt::Result::Error;
+    }
+    if(baseline.getFunction() != f_arg_function) {
+        std::cerr << "Warning: baseline was recorded for '" << baseline.getFunction() << "'" << std::endl;
+    }
+    if(SetMainFunction(executor) != wabt::Result::Ok) {
+        return wabt::Result::Error;
+    }
+    wdb::Tracer tracer(executor, &moduleIndex);
+    wdb::TimingProfile timingProfile;
+    wdb::CallGraphProfile callGraphProfile;
+    tracer.addListener(&timingProfile);
+    tracer.addListener(&callGraphProfile);
+    if(tracer.run() != wabt::Result::Ok) {
+        std::cerr << "Error executing '" << f_arg_function << "'" << std::endl;
+        return wabt::Result::Error;
+    }
+    wdb::ProfileSnapshot current;
+    current.capture(f_arg_function, tracer, timingProfile, callGraphProfile);
+    bool saved = true;
+    if(!f_saveProfileFile.empty() && !current.save(f_saveProfileFile)) {
+        std::cerr << "Error writing profile: " << f_saveProfileFile << std::endl;
+        saved = false;
+    }
+    int regressions = 0;
+    int missing = 0;
+    std::cout << "[Comparison results]" << std::endl;
+    for(auto &check : wdb::ProfileSnapshot::compare(baseline, current, f_compareThreshold)) {
+        if(check.missing) {
+            missing++;
+            std::cout << "  MISSING    " << check.name << ": not run, " << check.base << " instructions in baseline"
+                      << std::endl;
+            continue;
+        }
+        if(check.regressed) {
+            regressions++;
+        }
+        // Format the delta apart, std::cout keeps its flags
+        std::ostringstream delta;
+        if(check.base == 0) {
+            delta << "no baseline";
         } else {
-            std::cerr << "Error setting '" << f_arg_function << "' as main function" << std::endl;
+            delta << std::showpos << std::fixed << std::setprecision(1) << check.getRelativeDelta() << "%";
         }
-    } else {
-        std::cerr << "Function '" << f_arg_function << "' was not found!" << std::endl;
+        std::cout << (check.regressed ? "  REGRESSION " : "  ok         ") << check.name << " " << check.metric
+                  << ": " << check.base << " -> " << check.current << " (" << delta.str() << ")" << std::endl;
     }
-    return wabt::Result::Error;
+    std::cout << "  " << regressions << " regression(s) above " << f_compareThreshold << "%" << std::endl;
+    if(missing > 0) {
+        std::cout << "  " << missing << " baseline function(s) missing"
+                  << (f_allowMissing ? ", allowed by --allow-missing" : "") << std::endl;
+    }
+    std::cout << "[End of results]" << std::endl;
+    bool passed = regressions == 0 && (missing == 0 || f_allowMissing);
+    return passed && saved ? wabt::Result::Ok : wabt::Result::Error;
+}
+
+wabt::Result Cover(wdb::WdbDebuggerExecutor* executor, wdb::ModuleIndex &moduleIndex, const std::string &inputFile) {
+    if(SetMainFunction(executor) != wabt::Result::Ok) {
+        return wabt::Result::Error;
+    }
+    wdb::Tracer tracer(executor, &moduleIndex);
+    // Coverage only records which instructions ran, reading the clock would double the cost of each one
+    tracer.setTimed(false);
+    wdb::CoverageProfile coverageProfile;
+    // Merge runs recorded in an existing file
+    std::ifstream previousFile(f_coverageFile);
+    if(previousFile.good() && !coverageProfile.load(f_coverageFile, tracer)) {
+        std::cerr << "Error merging coverage file: " << f_coverageFile << std::endl;
+        return wabt::Result::Error;
+    }
+    tracer.addListener(&coverageProfile);
+    // Coverage is saved even if the function traps
+    wabt::Result result = tracer.run();
+    if(result != wabt::Result::Ok) {
+        std::cerr << "Error executing '" << f_arg_function << "'" << std::endl;
+    }
+    if(!coverageProfile.save(f_coverageFile, inputFile, tracer)
+       || !coverageProfile.saveOffsets(f_coverageFile + ".offsets", tracer)) {
+        std::cerr << "Error writing coverage file: " << f_coverageFile << std::endl;
+        return wabt::Result::Error;
+    }
+    std::cout << "[Coverage results]" << std::endl;
+    for(auto &function : coverageProfile.getFunctionCoverage(tracer)) {
+        double percentage = function.total == 0 ? 0 : 100.0 * function.covered / function.total;
+        // Format the percentage apart, std::cout keeps its flags
+        std::ostringstream share;
+        share << std::fixed << std::setprecision(1) << percentage;
+        std::cout << "  " << function.name << ": " << function.covered << "/" << function.total
+                  << " (" << share.str() << "%)" << std::endl;
+    }
+    std::cout << "[End of results]" << std::endl;
+    return result;
+}
+
+/**
+ * Print benchmark statistics
+ * @param name
+ * @param statistics
+ * @param unit
+ */
+void PrintStatistics(const std::string &name, const wdb::Benchmark::Statistics &statistics, const std::string &unit) {
+    // Format values apart, std::cout keeps its flags
+    auto format = [](double value) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << value;
+        return text.str();
+    };
+    std::cout << "  " << name << std::endl
+              << "  ├ Min:    " << format(statistics.min) << unit << std::endl
+              << "  ├ Median: " << format(statistics.median) << unit << std::endl
+              << "  ├ Mean:   " << format(statistics.mean) << " ± " << format(statistics.ci95) << unit << " (95% CI)"
+              << std::endl
+              << "  ├ Stddev: " << format(statistics.stddev) << unit << std::endl
+              << "  └ Max:    " << format(statistics.max) << unit << std::endl;
+}
+
+wabt::Result Bench(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options options) {
+    // Module output would be repeated for every run
+    options.outputStreamHandler = [](std::string text) {};
+    wdb::Benchmark benchmark(&wdbWabt, options, f_arg_function);
+    if(benchmark.run(f_warmupIterations, f_benchIterations) != wabt::Result::Ok) {
+        std::cerr << benchmark.getError() << std::endl;
+        return wabt::Result::Error;
+    }
+    std::cout << "[Benchmark results]" << std::endl
+              << "  Function:   " << f_arg_function << std::endl
+              << "  Warmup:     " << f_warmupIterations << std::endl
+              << "  Iterations: " << benchmark.getSamples().size() << std::endl;
+    PrintStatistics("Wall Time", benchmark.getTimeStatistics(), " ns");
+    PrintStatistics("Instructions", benchmark.getInstructionStatistics(), "");
+    std::cout << "[End of results]" << std::endl;
+    if(!f_benchOutputFile.empty() && !benchmark.save(f_benchOutputFile)) {
+        std::cerr << "Error writing benchmark results: " << f_benchOutputFile << std::endl;
+        return wabt::Result::Error;
+    }
+    return wabt::Result::Ok;
+}
+
+/**
+ * Read debugger commands, skipping blank lines and '#' comments
+ * @param fileName '-' for stdin
+ * @return true if the file was read
+ */
+bool LoadScript(const std::string &fileName) {
+    std::ifstream file;
+    if(fileName != "-") {
+        file.open(fileName);
+        if(!file.is_open()) {
+            return false;
+        }
+    }
+    std::istream &in = fileName == "-" ? std::cin : file;
+    std::string line;
+    while(std::getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if(start != std::string::npos && line[start] != '#') {
+            f_scriptCommands.push_back(line.substr(start, line.find_last_not_of(" \t\r") - start + 1));
+        }
+    }
+    return true;
+}
+
+/**
+ * Run the script commands in a debug session without the tui
+ * @param wdbWabt
+ * @param options
+ * @param out receives commands, their messages and the program output
+ * @param err
+ * @return error if the executor was not created or a command was invalid
+ */
+wabt::Result Script(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options options, std::ostream &out,
+                    std::ostream &err = std::cerr) {
+    // Messages start on a new line after partial program output
+    bool lineOpen = false;
+    wdb::DebugSession session(&wdbWabt, options, [&out, &lineOpen](const std::string &text) {
+        out << text;
+        lineOpen = text.empty() ? lineOpen : text.back() != '\n';
+    }, [&out, &lineOpen](const std::string &text) {
+        out << (lineOpen ? "\n" : "") << text << std::endl;
+        lineOpen = false;
+    });
+    if(!session.getExecutor()) {
+        err << "Error creating executor" << std::endl;
+        return wabt::Result::Error;
+    }
+    bool failed = false;
+    for(auto &command : f_scriptCommands) {
+        out << (lineOpen ? "\n" : "") << "> " << command << std::endl;
+        lineOpen = false;
+        auto status = session.execute(command);
+        failed = failed || status == wdb::CommandRegistry::NOT_FOUND
+                 || status == wdb::CommandRegistry::INVALID_ARGUMENTS;
+    }
+    if(lineOpen) {
+        out << std::endl;
+    }
+    return failed ? wabt::Result::Error : wabt::Result::Ok;
+}
+
+/**
+ * Serve the debugger to one GDB or LLDB client
+ * @param wdbWabt
+ * @param options
+ * @return error if the server could not listen or the client disconnected
+ */
+wabt::Result GdbServe(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options options) {
+    wdb::GdbServer server(&wdbWabt, options);
+    if(!server.getSession().getExecutor()) {
+        std::cerr << "Error creating executor" << std::endl;
+        return wabt::Result::Error;
+    }
+    // Start at the -r function, otherwise the client sets it with 'monitor main <func>'
+    if(!f_arg_function.empty()) {
+        server.getSession().execute("main " + f_arg_function);
+    }
+    std::string error;
+    if(!server.listen(f_gdbAddress, error)) {
+        std::cerr << error << std::endl;
+        return wabt::Result::Error;
+    }
+    std::cerr << "Listening on " << f_gdbAddress << std::endl;
+    if(!server.serve(error)) {
+        std::cerr << error << std::endl;
+        return wabt::Result::Error;
+    }
+    return wabt::Result::Ok;
+}
+
+/**
+ * Serve the debugger to an editor over stdin and stdout
+ * @param wdbWabt
+ * @param options
+ * @param inputFile
+ * @return error if the editor closed the input without disconnecting
+ */
+wabt::Result DapServe(wdb::WdbWabt &wdbWabt, wdb::WdbExecutor::Options options, const std::string &inputFile) {
+    // Name the disassembly after the module
+    std::string sourceName = inputFile.substr(inputFile.find_last_of('/') + 1);
+    wdb::DapServer server(&wdbWabt, options, sourceName, std::cin, std::cout);
+    // Used when the launch request does not name a function
+    server.setMainFunction(f_arg_function);
+    std::string error;
+    if(!server.serve(error)) {
+        std::cerr << error << std::endl;
+        return wabt::Result::Error;
+    }
+    return wabt::Result::Ok;
+}
+
+/**
+ * Load and run one input file in -r or -p mode
+ * @param inputFile
+ * @param out
+ * @param err
+ * @return result
+ */
+wabt::Result RunFile(const std::string &inputFile, std::ostream &out, std::ostream &err) {
+    // Phases are only recorded for a single file, Batch() stops the timings
+    wdb::ModuleIndex moduleIndex;
+    {
+        wdb::ScopedTimer timer("open file");
+        // Mapping the file costs no read and rejects directories
+        wdb::MappedFile inputMapping(inputFile);
+        if(!inputMapping.isOpen()) {
+            err << "Error opening file: " << inputFile << std::endl;
+            return wabt::Result::Error;
+        }
+        if(inputMapping.getSize() == 0) {
+            err << "Error reading file: " << inputFile << " is empty" << std::endl;
+            return wabt::Result::Error;
+        }
+        // Functions that are not exported are found from the binary, the loader reports a malformed one
+        moduleIndex.readBinary(inputMapping.getData(), inputMapping.getSize());
+    }
+    // Skip parsing modules that already failed to load
+    wdb::ModuleCache cache(f_cache ? wdb::ModuleCache::getDefaultDirectory() : "");
+    std::string fileKey = f_cache ? wdb::ModuleCache::getFileKey(inputFile) : "";
+    std::string cachedError;
+    if(cache.isInvalid(fileKey, cachedError)) {
+        err << cachedError << " (cached)" << std::endl;
+        return wabt::Result::Error;
+    }
+    wdb::WdbWabt wdbWabt;
+    wabt::Result loadResult;
+    {
+        // Reading, parsing and validation all happen in the loader
+        wdb::ScopedTimer timer("load module");
+        loadResult = wdbWabt.LoadModuleFile(inputFile);
+    }
+    if(loadResult != wabt::Result::Ok) {
+        std::string error = "Error reading file: " + inputFile;
+        err << error << std::endl;
+        cache.setInvalid(fileKey, error);
+        return wabt::Result::Error;
+    }
+    wdb::WdbExecutor::Options options;
+    options.preSetup = InitHostFunctions;
+    options.outputStreamHandler = [&out](std::string text) {
+        out << text;
+    };
+    options.errorStreamHandler = [&err](std::string text) {
+        err << text;
+    };
+    if(!f_scriptFile.empty()) {
+        wdb::ScopedTimer timer("script");
+        return Script(wdbWabt, options, out, err);
+    }
+    if(f_profiler) {
+        wdb::WdbDebuggerExecutor* profilerExecutor;
+        {
+            wdb::ScopedTimer timer("instantiate");
+            profilerExecutor = wdbWabt.CreateWdbDebuggerExecutor(options);
+        }
+        if(!profilerExecutor) {
+            err << "Error creating profiler executor" << std::endl;
+            return wabt::Result::Error;
+        }
+        wdb::ScopedTimer timer("profile");
+        return Profile(profilerExecutor, moduleIndex, out, err);
+    }
+    wdb::WdbExecutor* executor;
+    {
+        wdb::ScopedTimer timer("instantiate");
+        executor = wdbWabt.CreateWdbExecutor(options);
+    }
+    if(!executor) {
+        err << "Error creating executor" << std::endl;
+        return wabt::Result::Error;
+    }
+    wdb::ScopedTimer timer("execute");
+    return Execute(executor, err);
+}
+
+/**
+ * Run every input file on a worker pool, printing output in input order
+ * @return exit status
+ */
+int Batch() {
+    struct FileResult {
+        std::stringstream out;
+        std::stringstream err;
+        bool done = false;
+        bool succeeded = false;
+        uint64_t time = 0;
+    };
+    std::vector<FileResult> results(inputFiles.size());
+    std::mutex printMutex;
+    size_t nextToPrint = 0;
+    auto start = std::chrono::steady_clock::now();
+    int threads = f_jobs > 0 ? f_jobs : wdb::ThreadPool::getHardwareThreads();
+    {
+        wdb::ThreadPool pool(std::min(threads, (int) inputFiles.size()));
+        for(size_t i=0; i < inputFiles.size(); i++) {
+            pool.submit([i, &results, &printMutex, &nextToPrint]() {
+                FileResult &result = results[i];
+                auto fileStart = std::chrono::steady_clock::now();
+                result.succeeded = RunFile(inputFiles[i], result.out, result.err) == wabt::Result::Ok;
+                result.time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - fileStart).count();
+                // Stream finished files as soon as all files before them are printed
+                std::lock_guard<std::mutex> lock(printMutex);
+                result.done = true;
+                while(nextToPrint < results.size() && results[nextToPrint].done) {
+                    FileResult &next = results[nextToPrint];
+                    std::cout << "[File: " << inputFiles[nextToPrint] << "]" << std::endl << next.out.str();
+                    std::cout.flush();
+                    std::cerr << next.err.str();
+                    next.out.str("");
+                    next.err.str("");
+                    nextToPrint++;
+                }
+            });
+        }
+        pool.wait();
+    }
+    uint64_t wallTime = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    // Aggregate summary
+    size_t failed = 0;
+    uint64_t totalTime = 0;
+    for(auto &result : results) {
+        failed += result.succeeded ? 0 : 1;
+        totalTime += result.time;
+    }
+    std::cout << "[Batch results]" << std::endl
+              << "  Files:      " << inputFiles.size() << std::endl
+              << "  Succeeded:  " << inputFiles.size() - failed << std::endl
+              << "  Failed:     " << failed << std::endl
+              << "  Threads:    " << std::min(threads, (int) inputFiles.size()) << std::endl
+              << "  Total Time: " << totalTime << " ns" << std::endl
+              << "  Wall Time:  " << wallTime << " ns" << std::endl;
+    for(size_t i=0; i < results.size(); i++) {
+        if(!results[i].succeeded) {
+            std::cout << "  Failed: " << inputFiles[i] << std::endl;
+        }
+    }
+    std::cout << "[End of results]" << std::endl;
+    return failed == 0 ? 0 : 1;
 }
 
 int main(int argc, char* argv[]) {
     // Init parameters
-    initParams(argc, argv);
+    {
+        wdb::ScopedTimer timer("parse arguments");
+        if(!initParams(argc, argv)) {
+            printUsage();
+            return 1;
+        }
+    }
 
     // Fetch files names
     for(int i = optind; i < argc; ++i) {
@@ -239,16 +1158,77 @@ int main(int argc, char* argv[]) {
     }
 
     // Check for require arguments
-    if(inputFiles.empty() || (!f_tuiEnabled && f_arg_function.empty())) {
+    if(inputFiles.empty() || (!f_tuiEnabled && !f_profileAll && f_arg_function.empty() && f_scriptFile.empty()
+                               && f_gdbAddress.empty() && !f_dap)) {
         printUsage();
         return 1;
     }
 
-    // Check if file exists
+    // Profiling runs first and would silently skip the coverage run
+    if(f_profiler && !f_coverageFile.empty()) {
+        std::cerr << "--coverage cannot be combined with --profiler" << std::endl;
+        return 1;
+    }
+
+    // Read the script once for every input file
+    if(!f_scriptFile.empty() && !LoadScript(f_scriptFile)) {
+        std::cerr << "Error reading script: " << f_scriptFile << std::endl;
+        return 1;
+    }
+
+    // -r, -p and -S run a single file the same way as every file of a batch, with the same exit status
+    bool fileRun = !f_tuiEnabled && !f_dap && f_gdbAddress.empty()
+                   && (!f_scriptFile.empty() || (!f_profileAll && !f_benchmark && f_compareFile.empty()
+                                                 && f_coverageFile.empty()));
+
+    // Run several files in parallel
+    if(inputFiles.size() > 1 && !f_tuiEnabled) {
+        if(!fileRun || !f_saveProfileFile.empty() || !f_memoryProfileFile.empty() || !f_growthTimelineFile.empty()
+           || !f_heapReportFile.empty()) {
+            std::cerr << "Several input files are only supported by -r, -p and -S without output files" << std::endl;
+            return 1;
+        }
+        // Phases of parallel runs would interleave
+        wdb::Timings::get().stop();
+        return Batch();
+    }
+    if(fileRun) {
+        int exitCode = RunFile(inputFiles.front(), std::cout, std::cerr) == wabt::Result::Ok ? 0 : 1;
+        if(f_timings) {
+            wdb::Timings::get().print(std::cerr);
+        }
+        return exitCode;
+    }
+
+    // Check if file exists, mapping it costs no read and rejects directories
     std::string inputFile = inputFiles.front();
-    std::ifstream inputFileStream(inputFile);
-    if(!inputFileStream.good()) {
-        std::cerr << "Error opening file: " << inputFile << std::endl;
+    std::string cacheKey;
+    wdb::ModuleIndex moduleIndex;
+    {
+        wdb::ScopedTimer timer("open file");
+        wdb::MappedFile inputMapping(inputFile);
+        if(!inputMapping.isOpen()) {
+            std::cerr << "Error opening file: " << inputFile << std::endl;
+            return 1;
+        }
+        if(inputMapping.getSize() == 0) {
+            std::cerr << "Error reading file: " << inputFile << " is empty" << std::endl;
+            return 1;
+        }
+        // Functions that are not exported are found from the binary, the loader reports a malformed one
+        moduleIndex.readBinary(inputMapping.getData(), inputMapping.getSize());
+        // Only the tui has content to cache, the generated text
+        if(f_cache && f_tuiEnabled) {
+            wdb::ScopedTimer hashTimer("hash");
+            cacheKey = wdb::ModuleCache::getKey(inputMapping.getData(), inputMapping.getSize());
+        }
+    }
+    wdb::ModuleCache cache(f_cache ? wdb::ModuleCache::getDefaultDirectory() : "");
+    std::string fileKey = f_cache ? wdb::ModuleCache::getFileKey(inputFile) : "";
+    std::string cachedError;
+    if(cache.isInvalid(fileKey, cachedError)) {
+        // Known bad module, skip parsing and validation, the status is the same as uncached
+        std::cerr << cachedError << " (cached)" << std::endl;
         return 1;
     }
 
@@ -256,10 +1236,22 @@ int main(int argc, char* argv[]) {
     wdb::WdbWabt wdbWabt;
     wdb::WdbExecutor::Options options;
     options.preSetup = InitHostFunctions;
-    if(wdbWabt.LoadModuleFile(inputFile) == wabt::Result::Ok) {
+    wabt::Result loadResult;
+    {
+        // Reading, parsing and validation all happen in the loader
+        wdb::ScopedTimer timer("load module");
+        loadResult = wdbWabt.LoadModuleFile(inputFile);
+    }
+    if(loadResult != wabt::Result::Ok) {
+        cache.setInvalid(fileKey, "Error reading file: " + inputFile);
+    }
+    int exitCode = 0;
+    if(loadResult == wabt::Result::Ok) {
         if(f_tuiEnabled) {
             // Open in tui mode
-            tui(wdbWabt, options);
+            if(!tui(wdbWabt, options, moduleIndex, cache.isEnabled() ? &cache : nullptr, cacheKey)) {
+                exitCode = 1;
+            }
         } else {
             // Update options for non-tui
             options.outputStreamHandler = [](std::string text) {
@@ -268,34 +1260,47 @@ int main(int argc, char* argv[]) {
             options.errorStreamHandler = [](std::string text) {
                 std::cerr << text;
             };
-            if(f_profiler) {
-                wdb::WdbProfilerExecutor* profilerExecutor = wdbWabt.CreateWdbProfilerExecutor(options);
-                if(profilerExecutor) {
-                    if(Execute(profilerExecutor) == wabt::Result::Ok) {
-                        std::cout << "[Profiler results]" << std::endl;
-                        auto data = profilerExecutor->GetProfilerMap();
-                        for(auto entry : data) {
-                            std::cout << "  " << entry.second.GetOpcode().GetName() << std::endl
-                                      << "  ├ Count:      " << entry.second.GetCount() << std::endl
-                                      << "  ├ Total Time: " << entry.second.GetTotalTime() << " ns" << std::endl
-                                      << "  └ Avg. Time:  " << entry.second.GetAverageTime() << " ns" << std::endl;
-                        }
-                        std::cout << "[End of results]" << std::endl;
-                    }
-                } else {
-                    std::cerr << "Error creating profiler executor" << std::endl;
+            if(f_dap) {
+                if(DapServe(wdbWabt, options, inputFile) != wabt::Result::Ok) {
+                    exitCode = 1;
+                }
+            } else if(!f_gdbAddress.empty()) {
+                if(GdbServe(wdbWabt, options) != wabt::Result::Ok) {
+                    exitCode = 1;
                 }
-            } else {
-                wdb::WdbExecutor* executor = wdbWabt.CreateWdbExecutor(options);
-                if(executor) {
-                    Execute(executor);
-                } else {
+            } else if(f_profileAll) {
+                if(ProfileAll(wdbWabt, options, moduleIndex) != wabt::Result::Ok) {
+                    exitCode = 1;
+                }
+            } else if(f_benchmark) {
+                if(Bench(wdbWabt, options) != wabt::Result::Ok) {
+                    exitCode = 1;
+                }
+            } else if(!f_compareFile.empty()) {
+                wdb::WdbDebuggerExecutor* compareExecutor = wdbWabt.CreateWdbDebuggerExecutor(options);
+                if(!compareExecutor) {
+                    std::cerr << "Error creating executor" << std::endl;
+                    exitCode = 1;
+                } else if(Compare(compareExecutor, moduleIndex) != wabt::Result::Ok) {
+                    // Exit status gates pre-merge scripts
+                    exitCode = 1;
+                }
+            } else if(!f_coverageFile.empty()) {
+                wdb::WdbDebuggerExecutor* coverageExecutor = wdbWabt.CreateWdbDebuggerExecutor(options);
+                if(!coverageExecutor) {
                     std::cerr << "Error creating executor" << std::endl;
+                    exitCode = 1;
+                } else if(Cover(coverageExecutor, moduleIndex, inputFile) != wabt::Result::Ok) {
+                    exitCode = 1;
                 }
             }
         }
     } else {
         std::cerr << "Error reading file: " << inputFile << std::endl;
+        exitCode = 1;
+    }
+    if(f_timings) {
+        wdb::Timings::get().print(std::cerr);
     }
+    return exitCode;
 }
-
@@ -0,0 +1,169 @@
+#include <wdb_tui/benchmark.h>
+#include <wdb_tui/json.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+
+namespace wdb {
+    namespace {
+        // Two-sided 95% Student's t critical values for 1 to 30 degrees of freedom
+        const double T_95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                               2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                               2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+        Json ToJson(const Benchmark::Statistics &statistics) {
+            Json object = Json::object();
+            object["min"] = statistics.min;
+            object["max"] = statistics.max;
+            object["median"] = statistics.median;
+            object["mean"] = statistics.mean;
+            object["stddev"] = statistics.stddev;
+            object["ci95"] = statistics.ci95;
+            return object;
+        }
+    }
+
+    Benchmark::Statistics Benchmark::Statistics::compute(std::vector<double> values) {
+        Statistics statistics;
+        if(values.empty()) {
+            return statistics;
+        }
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        statistics.min = values.front();
+        statistics.max = values.back();
+        statistics.median = n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+        double sum = 0;
+        for(double value : values) {
+            sum += value;
+        }
+        statistics.mean = sum / n;
+        if(n > 1) {
+            double squares = 0;
+            for(double value : values) {
+                squares += (value - statistics.mean) * (value - statistics.mean);
+            }
+            statistics.stddev = std::sqrt(squares / (n - 1));
+            double t = n - 1 <= 30 ? T_95[n - 2] : 1.96;
+            statistics.ci95 = t * statistics.stddev / std::sqrt((double) n);
+        }
+        return statistics;
+    }
+
+    Benchmark::Benchmark(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, std::string function) {
+        m_wdbWabt = wdbWabt;
+        m_options = options;
+        m_function = function;
+    }
+
+    wabt::Result Benchmark::setMainFunction(wdb::WdbExecutor *executor) {
+        if(!executor) {
+            m_error = "Error creating executor";
+            return wabt::Result::Error;
+        }
+        wabt::interp::Export* e = nullptr;
+        if(executor->SearchExportedModuleFunction(executor->GetMainModule(), m_function, &e) != wabt::Result::Ok) {
+            m_error = "Function '" + m_function + "' was not found!";
+            return wabt::Result::Error;
+        }
+        if(executor->SetMainFunction(executor->GetFunction(e->index)) != wabt::Result::Ok) {
+            m_error = "Error setting '" + m_function + "' as main function";
+            return wabt::Result::Error;
+        }
+        return wabt::Result::Ok;
+    }
+
+    wabt::Result Benchmark::measureTime(uint64_t &time) {
+        // Instantiation is not part of the measurement
+        wdb::WdbExecutor *executor = m_wdbWabt->CreateWdbExecutor(m_options);
+        if(setMainFunction(executor) != wabt::Result::Ok) {
+            return wabt::Result::Error;
+        }
+        auto start = std::chrono::steady_clock::now();
+        wabt::Result result = executor->Execute();
+        time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        if(result != wabt::Result::Ok) {
+            m_error = "Error executing '" + m_function + "'";
+        }
+        return result;
+    }
+
+    wabt::Result Benchmark::countInstructions(uint64_t &instructions) {
+        // Counting needs the profiler, so it runs apart from the timed call
+        wdb::WdbProfilerExecutor *executor = m_wdbWabt->CreateWdbProfilerExecutor(m_options);
+        if(setMainFunction(executor) != wabt::Result::Ok) {
+            return wabt::Result::Error;
+        }
+        if(executor->Execute() != wabt::Result::Ok) {
+            m_error = "Error executing '" + m_function + "'";
+            return wabt::Result::Error;
+        }
+        instructions = 0;
+        for(auto entry : executor->GetProfilerMap()) {
+            instructions += entry.second.GetCount();
+        }
+        return wabt::Result::Ok;
+    }
+
+    wabt::Result Benchmark::run(int warmup, int iterations) {
+        m_samples.clear();
+        m_warmup = warmup;
+        uint64_t ignored;
+        for(int i=0; i < warmup; i++) {
+            if(measureTime(ignored) != wabt::Result::Ok) {
+                return wabt::Result::Error;
+            }
+        }
+        for(int i=0; i < iterations; i++) {
+            Sample sample;
+            if(measureTime(sample.time) != wabt::Result::Ok
+               || countInstructions(sample.instructions) != wabt::Result::Ok) {
+                return wabt::Result::Error;
+            }
+            m_samples.push_back(sample);
+        }
+        return wabt::Result::Ok;
+    }
+
+    Benchmark::Statistics Benchmark::getTimeStatistics() const {
+        std::vector<double> values;
+        for(auto &sample : m_samples) {
+            values.push_back((double) sample.time);
+        }
+        return Statistics::compute(values);
+    }
+
+    Benchmark::Statistics Benchmark::getInstructionStatistics() const {
+        std::vector<double> values;
+        for(auto &sample : m_samples) {
+            values.push_back((double) sample.instructions);
+        }
+        return Statistics::compute(values);
+    }
+
+    bool Benchmark::save(const std::string &fileName) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        // Numbers are written exactly, for tracking results over time
+        Json root = Json::object();
+        root["function"] = m_function;
+        root["warmup"] = m_warmup;
+        root["iterations"] = (uint64_t) m_samples.size();
+        root["time_ns"] = ToJson(getTimeStatistics());
+        root["instructions"] = ToJson(getInstructionStatistics());
+        Json samples = Json::array();
+        for(auto &sample : m_samples) {
+            Json object = Json::object();
+            object["time_ns"] = sample.time;
+            object["instructions"] = sample.instructions;
+            samples.push(object);
+        }
+        root["samples"] = samples;
+        file << root.dump(2) << std::endl;
+        return file.good();
+    }
+}
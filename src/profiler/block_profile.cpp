@@ -0,0 +1,13 @@
+#include <wdb_tui/block_profile.h>
+
+namespace wdb {
+    void BlockProfile::reset() {
+        m_counts.clear();
+        m_maxCount = 0;
+    }
+
+    void BlockProfile::onStart(Tracer &tracer) {
+        m_counts.assign((size_t) tracer.getBlockCount(), 0);
+        m_maxCount = 0;
+    }
+}
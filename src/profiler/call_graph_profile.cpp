@@ -0,0 +1,49 @@
+#include <wdb_tui/call_graph_profile.h>
+#include <algorithm>
+
+namespace wdb {
+    const int CallGraphProfile::ROOT;
+
+    void CallGraphProfile::reset() {
+        m_names.clear();
+        m_edges.clear();
+        m_edgeIndex.clear();
+        m_stack.clear();
+    }
+
+    void CallGraphProfile::onStart(Tracer &tracer) {
+        reset();
+        for(auto &function : tracer.getFunctions()) {
+            m_names.push_back(function.name);
+        }
+    }
+
+    void CallGraphProfile::onCall(Tracer &tracer, int function, int callSite) {
+        int caller = callSite < 0 ? ROOT : tracer.getInstruction(callSite).function;
+        uint64_t key = ((uint64_t) (uint32_t) caller << 32) | (uint32_t) function;
+        auto edge = m_edgeIndex.find(key);
+        if(edge == m_edgeIndex.end()) {
+            edge = m_edgeIndex.emplace(key, m_edges.size()).first;
+            Edge newEdge;
+            newEdge.caller = getName(caller);
+            newEdge.callee = getName(function);
+            m_edges.push_back(newEdge);
+        }
+        m_stack.push_back(edge->second);
+    }
+
+    std::string CallGraphProfile::getName(int function) const {
+        if(function == ROOT) {
+            return "<root>";
+        }
+        return function < 0 || function >= (int) m_names.size() ? "<unknown>" : m_names[function];
+    }
+
+    std::vector<CallGraphProfile::Edge> CallGraphProfile::getEdges() const {
+        std::vector<Edge> edges = m_edges;
+        std::sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) {
+            return a.totalTime > b.totalTime;
+        });
+        return edges;
+    }
+}
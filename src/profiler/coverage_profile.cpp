@@ -0,0 +1,119 @@
+#include <wdb_tui/coverage_profile.h>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace wdb {
+    void CoverageProfile::onStart(Tracer &tracer) {
+        m_bitmap.assign((tracer.getInstructions().size() + 63) / 64, 0);
+    }
+
+    uint32_t CoverageProfile::getHits(int index) const {
+        uint32_t hits = isCovered(index) ? 1 : 0;
+        if(index >= 0 && index < m_previousHits.size()) {
+            hits += m_previousHits[index];
+        }
+        return hits;
+    }
+
+    bool CoverageProfile::load(const std::string &fileName, const Tracer &tracer) {
+        std::ifstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        size_t numInstructions = tracer.getInstructions().size();
+        std::vector<uint32_t> hits(numInstructions, 0);
+        std::string record;
+        while(std::getline(file, record)) {
+            unsigned long line = 0;
+            unsigned long count = 0;
+            if(record.compare(0, 3, "DA:") == 0) {
+                // DA:<line>,<hits>
+                char comma;
+                std::istringstream ss(record.substr(3));
+                if(!(ss >> line >> comma >> count) || line < 1 || line > numInstructions) {
+                    return false;
+                }
+                hits[line - 1] += (uint32_t) count;
+            } else if(record.compare(0, 3, "LF:") == 0) {
+                // Tracefile must describe the same module
+                const char *text = record.c_str() + 3;
+                char *end = nullptr;
+                count = std::strtoul(text, &end, 10);
+                if(end == text || *end != '\0' || count != numInstructions) {
+                    return false;
+                }
+            }
+        }
+        m_previousHits = hits;
+        return true;
+    }
+
+    bool CoverageProfile::save(const std::string &fileName, const std::string &sourceName,
+                               const Tracer &tracer) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        file << "TN:" << std::endl;
+        file << "SF:" << sourceName << std::endl;
+        // Functions
+        int functionsHit = 0;
+        for(auto &function : tracer.getFunctions()) {
+            file << "FN:" << function.firstInstruction + 1 << "," << function.name << std::endl;
+        }
+        for(auto &function : tracer.getFunctions()) {
+            uint32_t hits = getHits(function.firstInstruction);
+            file << "FNDA:" << hits << "," << function.name << std::endl;
+            if(hits > 0) {
+                functionsHit++;
+            }
+        }
+        file << "FNF:" << tracer.getFunctions().size() << std::endl;
+        file << "FNH:" << functionsHit << std::endl;
+        // Instructions
+        int linesHit = 0;
+        for(int i=0; i < tracer.getInstructions().size(); i++) {
+            uint32_t hits = getHits(i);
+            file << "DA:" << i + 1 << "," << hits << std::endl;
+            if(hits > 0) {
+                linesHit++;
+            }
+        }
+        file << "LF:" << tracer.getInstructions().size() << std::endl;
+        file << "LH:" << linesHit << std::endl;
+        file << "end_of_record" << std::endl;
+        return file.good();
+    }
+
+    bool CoverageProfile::saveOffsets(const std::string &fileName, const Tracer &tracer) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        for(int i=0; i < tracer.getInstructions().size(); i++) {
+            if(getHits(i) > 0) {
+                file << "0x" << std::setfill('0') << std::setw(8) << std::hex << tracer.getInstruction(i).offset
+                     << std::endl;
+            }
+        }
+        return file.good();
+    }
+
+    std::vector<CoverageProfile::FunctionCoverage> CoverageProfile::getFunctionCoverage(const Tracer &tracer) const {
+        std::vector<FunctionCoverage> coverage;
+        for(auto &function : tracer.getFunctions()) {
+            FunctionCoverage functionCoverage;
+            functionCoverage.name = function.name;
+            functionCoverage.total = function.endInstruction - function.firstInstruction;
+            for(int i=function.firstInstruction; i < function.endInstruction; i++) {
+                if(getHits(i) > 0) {
+                    functionCoverage.covered++;
+                }
+            }
+            coverage.push_back(functionCoverage);
+        }
+        return coverage;
+    }
+}
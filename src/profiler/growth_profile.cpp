@@ -0,0 +1,95 @@
+#include <wdb_tui/growth_profile.h>
+#include <fstream>
+
+namespace wdb {
+    const int GrowthProfile::WASM_PAGE_BITS;
+
+    void GrowthProfile::reset() {
+        m_events.clear();
+        m_usage.clear();
+        m_touched.clear();
+    }
+
+    void GrowthProfile::onStart(Tracer &tracer) {
+        reset();
+        m_startTime = std::chrono::steady_clock::now();
+        m_usage.resize((size_t) tracer.getExecutor()->GetMemoriesCount());
+        m_touched.resize(m_usage.size());
+        for(uint32_t i=0; i < m_usage.size(); i++) {
+            m_usage[i].initialPages = getPages(tracer, i);
+            m_usage[i].peakPages = m_usage[i].initialPages;
+            m_touched[i].assign(m_usage[i].initialPages, false);
+        }
+    }
+
+    uint32_t GrowthProfile::getPages(Tracer &tracer, uint32_t memory) {
+        return (uint32_t) ((uint64_t) tracer.getExecutor()->GetMemorySize(memory) >> WASM_PAGE_BITS);
+    }
+
+    void GrowthProfile::recordAccess(Tracer &tracer, const Tracer::Instruction &instruction) {
+        uint64_t address;
+        if(instruction.memory >= m_usage.size() || !tracer.getAccessAddress(instruction, address)) {
+            return;
+        }
+        uint64_t page = address >> WASM_PAGE_BITS;
+        auto &touched = m_touched[instruction.memory];
+        if(page >= touched.size() || touched[page]) {
+            return;
+        }
+        touched[page] = true;
+        auto &usage = m_usage[instruction.memory];
+        usage.touchedPages++;
+        if(page + 1 > usage.touchedHighWater) {
+            usage.touchedHighWater = (uint32_t) page + 1;
+        }
+    }
+
+    void GrowthProfile::beginGrow(Tracer &tracer, const Tracer::Instruction &instruction) {
+        auto executor = tracer.getExecutor();
+        m_pending = Event();
+        m_pending.memory = instruction.memory;
+        m_pending.instructionCount = tracer.getInstructionCount();
+        m_pending.timestamp = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_startTime).count();
+        int function = tracer.getCurrentFunction();
+        m_pending.function = function < 0 ? "<unknown>" : tracer.getFunction(function).name;
+        if(instruction.memory < m_usage.size()) {
+            m_pending.previousPages = getPages(tracer, instruction.memory);
+        }
+        if(executor->GetStackSize() > 0) {
+            m_pending.requestedPages = executor->GetStackAt(executor->GetStackSize() - 1).i32;
+        }
+    }
+
+    void GrowthProfile::endGrow(Tracer &tracer) {
+        if(m_pending.memory >= m_usage.size()) {
+            return;
+        }
+        m_pending.pages = getPages(tracer, m_pending.memory);
+        m_events.push_back(m_pending);
+        // Track peak and make room for the new pages
+        auto &usage = m_usage[m_pending.memory];
+        if(m_pending.pages > usage.peakPages) {
+            usage.peakPages = m_pending.pages;
+        }
+        m_touched[m_pending.memory].resize(m_pending.pages, false);
+    }
+
+    bool GrowthProfile::save(const std::string &fileName) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        file << "time_ns,instructions,function,memory,previous_pages,requested_pages,pages" << std::endl;
+        for(auto &event : m_events) {
+            file << event.timestamp << ","
+                 << event.instructionCount << ","
+                 << event.function << ","
+                 << event.memory << ","
+                 << event.previousPages << ","
+                 << event.requestedPages << ","
+                 << event.pages << std::endl;
+        }
+        return file.good();
+    }
+}
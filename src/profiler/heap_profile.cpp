@@ -0,0 +1,247 @@
+#include <wdb_tui/heap_profile.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace wdb {
+    namespace {
+        /**
+         * Parse a '#<index>' hook
+         */
+        bool ParseFunctionIndex(const std::string &hook, uint32_t &index) {
+            if(hook.size() < 2 || hook[0] != '#' || !std::isdigit(hook[1])) {
+                return false;
+            }
+            char *end = nullptr;
+            errno = 0;
+            unsigned long value = std::strtoul(hook.c_str() + 1, &end, 10);
+            if(*end != '\0' || errno == ERANGE || value > UINT32_MAX) {
+                return false;
+            }
+            index = (uint32_t) value;
+            return true;
+        }
+    }
+
+    bool HeapProfile::parseHooks(const std::string &text, Hooks &hooks) {
+        std::istringstream ss(text);
+        std::string entry;
+        while(std::getline(ss, entry, ',')) {
+            size_t equal = entry.find('=');
+            if(equal == std::string::npos || equal + 1 == entry.size()) {
+                return false;
+            }
+            std::string key = entry.substr(0, equal);
+            std::string value = entry.substr(equal + 1);
+            uint32_t index;
+            if(value[0] == '#' && !ParseFunctionIndex(value, index)) {
+                return false;
+            }
+            if(key == "malloc") {
+                hooks.malloc = value;
+            } else if(key == "calloc") {
+                hooks.calloc = value;
+            } else if(key == "realloc") {
+                hooks.realloc = value;
+            } else if(key == "free") {
+                hooks.free = value;
+            } else {
+                return false;
+            }
+        }
+        return !hooks.empty();
+    }
+
+    void HeapProfile::reset() {
+        m_pending.clear();
+        m_live.clear();
+        m_sites.clear();
+        m_summary = Summary();
+    }
+
+    void HeapProfile::onStart(Tracer &tracer) {
+        reset();
+        m_functionKinds.assign(tracer.getFunctions().size(), NONE);
+        m_enabled = false;
+        resolveHook(tracer, m_hooks.malloc, MALLOC);
+        resolveHook(tracer, m_hooks.calloc, CALLOC);
+        resolveHook(tracer, m_hooks.realloc, REALLOC);
+        resolveHook(tracer, m_hooks.free, FREE);
+    }
+
+    void HeapProfile::resolveHook(Tracer &tracer, const std::string &hook, Kind kind) {
+        if(hook.empty()) {
+            return;
+        }
+        int function = -1;
+        uint32_t index;
+        if(ParseFunctionIndex(hook, index)) {
+            // Module function index, the function may not be exported
+            for(int i=0; i < tracer.getFunctions().size(); i++) {
+                if(tracer.getFunction(i).index == (int64_t) index) {
+                    function = i;
+                    break;
+                }
+            }
+        } else {
+            for(int i=0; i < tracer.getFunctions().size(); i++) {
+                if(tracer.getFunction(i).name == hook) {
+                    function = i;
+                    break;
+                }
+            }
+        }
+        if(function >= 0) {
+            m_functionKinds[function] = kind;
+            m_enabled = true;
+        }
+    }
+
+    void HeapProfile::enterAllocator(Tracer &tracer, int function, int callSite) {
+        // Ignore allocator calls made by the allocator itself
+        if(!m_pending.empty()) {
+            return;
+        }
+        // Arguments are the callee's first locals, last argument on top
+        auto executor = tracer.getExecutor();
+        int top = executor->GetStackSize() - 1;
+        auto getArgument = [&](int fromTop) -> uint32_t {
+            return top - fromTop >= 0 ? executor->GetStackAt(top - fromTop).i32 : 0;
+        };
+        // Name the allocation site after its caller
+        if(m_sites.find(callSite) == m_sites.end()) {
+            Site site;
+            if(callSite < 0) {
+                site.name = "<main>";
+            } else {
+                auto &instruction = tracer.getInstruction(callSite);
+                std::stringstream ss;
+                ss << (instruction.function < 0 ? "<unknown>" : tracer.getFunction(instruction.function).name)
+                   << "@" << instruction.offset;
+                site.name = ss.str();
+            }
+            m_sites[callSite] = site;
+        }
+        Pending pending = {m_functionKinds[function], tracer.getCallDepth(), callSite, 0, 0};
+        switch (pending.kind) {
+            case MALLOC:
+                pending.size = getArgument(0);
+                break;
+            case CALLOC:
+                pending.size = (uint64_t) getArgument(1) * getArgument(0);
+                break;
+            case REALLOC:
+                pending.previous = getArgument(1);
+                pending.size = getArgument(0);
+                break;
+            case FREE:
+                release(getArgument(0));
+                return;
+            default:
+                return;
+        }
+        m_pending.push_back(pending);
+    }
+
+    void HeapProfile::leaveAllocator(Tracer &tracer) {
+        Pending pending = m_pending.back();
+        m_pending.pop_back();
+        auto executor = tracer.getExecutor();
+        if(executor->GetStackSize() == 0) {
+            return;
+        }
+        uint32_t pointer = executor->GetStackAt(executor->GetStackSize() - 1).i32;
+        // A successful realloc releases the previous block
+        if(pending.kind == REALLOC && (pointer != 0 || pending.size == 0)) {
+            release(pending.previous);
+        }
+        if(pointer != 0) {
+            allocate(pointer, pending.size, pending.site);
+        }
+    }
+
+    void HeapProfile::allocate(uint32_t pointer, uint64_t size, int site) {
+        // Pointer reused without a free we saw
+        if(m_live.find(pointer) != m_live.end()) {
+            release(pointer);
+            m_summary.frees--;
+        }
+        m_live[pointer] = {size, site};
+        Site &stats = m_sites[site];
+        stats.allocations++;
+        stats.bytes += size;
+        stats.liveAllocations++;
+        stats.liveBytes += size;
+        m_summary.allocations++;
+        m_summary.bytes += size;
+        m_summary.liveAllocations++;
+        m_summary.liveBytes += size;
+        m_summary.peakLiveBytes = std::max(m_summary.peakLiveBytes, m_summary.liveBytes);
+    }
+
+    void HeapProfile::release(uint32_t pointer) {
+        if(pointer == 0) {
+            return;
+        }
+        auto allocation = m_live.find(pointer);
+        if(allocation == m_live.end()) {
+            m_summary.invalidFrees++;
+            return;
+        }
+        Site &stats = m_sites[allocation->second.site];
+        stats.liveAllocations--;
+        stats.liveBytes -= allocation->second.size;
+        m_summary.frees++;
+        m_summary.liveAllocations--;
+        m_summary.liveBytes -= allocation->second.size;
+        m_live.erase(allocation);
+    }
+
+    std::vector<HeapProfile::Site> HeapProfile::getSites() const {
+        std::vector<Site> sites;
+        for(auto &site : m_sites) {
+            if(site.second.allocations > 0) {
+                sites.push_back(site.second);
+            }
+        }
+        std::sort(sites.begin(), sites.end(), [](const Site &a, const Site &b) {
+            if(a.liveBytes != b.liveBytes) {
+                return a.liveBytes > b.liveBytes;
+            }
+            return a.bytes > b.bytes;
+        });
+        return sites;
+    }
+
+    bool HeapProfile::save(const std::string &fileName) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        file << "# summary" << std::endl
+             << "allocations " << m_summary.allocations << std::endl
+             << "frees " << m_summary.frees << std::endl
+             << "bytes " << m_summary.bytes << std::endl
+             << "live_allocations " << m_summary.liveAllocations << std::endl
+             << "live_bytes " << m_summary.liveBytes << std::endl
+             << "peak_live_bytes " << m_summary.peakLiveBytes << std::endl
+             << "invalid_frees " << m_summary.invalidFrees << std::endl;
+        file << "# site allocations bytes live_allocations live_bytes" << std::endl;
+        for(auto &site : getSites()) {
+            file << site.name << " " << site.allocations << " " << site.bytes << " " << site.liveAllocations << " "
+                 << site.liveBytes << std::endl;
+        }
+        file << "# leak pointer size site" << std::endl;
+        for(auto &allocation : m_live) {
+            auto site = m_sites.find(allocation.second.site);
+            file << "0x" << std::setfill('0') << std::setw(8) << std::hex << allocation.first << std::dec << " "
+                 << allocation.second.size << " " << (site == m_sites.end() ? "<unknown>" : site->second.name)
+                 << std::endl;
+        }
+        return file.good();
+    }
+}
@@ -0,0 +1,62 @@
+#include <wdb_tui/latency_histogram.h>
+#include <cmath>
+
+namespace wdb {
+    const int LatencyHistogram::SUB_BUCKET_BITS;
+    const int LatencyHistogram::SUB_BUCKETS;
+    const int LatencyHistogram::MAX_VALUE_BITS;
+    const int LatencyHistogram::BUCKETS;
+    const uint64_t LatencyHistogram::MAX_VALUE;
+
+    void LatencyHistogram::reset() {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_min = UINT64_MAX;
+        m_max = 0;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other) {
+        for(int i=0; i < BUCKETS; i++) {
+            m_buckets[i] += other.m_buckets[i];
+        }
+        m_count += other.m_count;
+        if(other.m_min < m_min) {
+            m_min = other.m_min;
+        }
+        if(other.m_max > m_max) {
+            m_max = other.m_max;
+        }
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double percentile) const {
+        if(m_count == 0) {
+            return 0;
+        }
+        // Rank of the value we are looking for
+        auto rank = (uint64_t) std::ceil(percentile / 100.0 * m_count);
+        if(rank < 1) {
+            rank = 1;
+        } else if(rank > m_count) {
+            rank = m_count;
+        }
+        // Walk buckets until rank is reached
+        uint64_t seen = 0;
+        for(int i=0; i < BUCKETS; i++) {
+            seen += m_buckets[i];
+            if(seen >= rank) {
+                uint64_t value = bucketUpperBound(i);
+                return value < m_max ? value : m_max;
+            }
+        }
+        return m_max;
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(int index) {
+        if(index < SUB_BUCKETS) {
+            return (uint64_t) index;
+        }
+        int shift = (index >> SUB_BUCKET_BITS) - 1;
+        uint64_t top = (uint64_t) (index - (shift << SUB_BUCKET_BITS));
+        return ((top + 1) << shift) - 1;
+    }
+}
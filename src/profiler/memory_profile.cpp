@@ -0,0 +1,103 @@
+#include <wdb_tui/memory_profile.h>
+#include <algorithm>
+#include <fstream>
+
+namespace wdb {
+    const int MemoryProfile::PAGE_BITS;
+    const int MemoryProfile::LINE_BITS;
+
+    void MemoryProfile::onStart(Tracer &tracer) {
+        m_memories.clear();
+        m_memories.resize((size_t) tracer.getExecutor()->GetMemoriesCount());
+        for(uint32_t i=0; i < m_memories.size(); i++) {
+            resize(tracer, i);
+        }
+    }
+
+    void MemoryProfile::resize(Tracer &tracer, uint32_t memory) {
+        auto size = (uint64_t) tracer.getExecutor()->GetMemorySize(memory);
+        auto &counters = m_memories[memory];
+        counters.pageReads.resize((size + (1 << PAGE_BITS) - 1) >> PAGE_BITS, 0);
+        counters.pageWrites.resize(counters.pageReads.size(), 0);
+        if(m_lines) {
+            counters.lineReads.resize((size + (1 << LINE_BITS) - 1) >> LINE_BITS, 0);
+            counters.lineWrites.resize(counters.lineReads.size(), 0);
+        }
+    }
+
+    void MemoryProfile::recordAccess(Tracer &tracer, const Tracer::Instruction &instruction) {
+        if(instruction.memory >= m_memories.size()) {
+            return;
+        }
+        uint64_t address;
+        if(!tracer.getAccessAddress(instruction, address)) {
+            return;
+        }
+        auto &counters = m_memories[instruction.memory];
+        uint64_t page = address >> PAGE_BITS;
+        if(page >= counters.pageReads.size()) {
+            // Memory may have grown since the last access
+            resize(tracer, instruction.memory);
+            if(page >= counters.pageReads.size()) {
+                return; // Out of bounds, the instruction will trap
+            }
+        }
+        bool load = instruction.kind == Tracer::LOAD;
+        (load ? counters.pageReads : counters.pageWrites)[page]++;
+        if(m_lines) {
+            uint64_t line = address >> LINE_BITS;
+            (load ? counters.lineReads : counters.lineWrites)[line]++;
+        }
+    }
+
+    std::vector<MemoryProfile::Region> MemoryProfile::getHottestPages(int k) const {
+        return getHottest(false, k);
+    }
+
+    std::vector<MemoryProfile::Region> MemoryProfile::getHottestLines(int k) const {
+        return getHottest(true, k);
+    }
+
+    std::vector<MemoryProfile::Region> MemoryProfile::getHottest(bool lines, int k) const {
+        std::vector<Region> regions;
+        for(uint32_t memory=0; memory < m_memories.size(); memory++) {
+            auto &reads = lines ? m_memories[memory].lineReads : m_memories[memory].pageReads;
+            auto &writes = lines ? m_memories[memory].lineWrites : m_memories[memory].pageWrites;
+            for(uint64_t i=0; i < reads.size(); i++) {
+                if(reads[i] > 0 || writes[i] > 0) {
+                    Region region;
+                    region.memory = memory;
+                    region.index = i;
+                    region.reads = reads[i];
+                    region.writes = writes[i];
+                    regions.push_back(region);
+                }
+            }
+        }
+        size_t top = std::min(regions.size(), (size_t) std::max(k, 0));
+        std::partial_sort(regions.begin(), regions.begin() + top, regions.end(), [](const Region &a, const Region &b) {
+            return a.reads + a.writes > b.reads + b.writes;
+        });
+        regions.resize(top);
+        return regions;
+    }
+
+    bool MemoryProfile::save(const std::string &fileName) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        file << "# kind memory address reads writes" << std::endl;
+        for(auto &page : getHottestPages(INT32_MAX)) {
+            file << "page " << page.memory << " " << page.getAddress(PAGE_BITS) << " " << page.reads << " "
+                 << page.writes << std::endl;
+        }
+        if(m_lines) {
+            for(auto &line : getHottestLines(INT32_MAX)) {
+                file << "line " << line.memory << " " << line.getAddress(LINE_BITS) << " " << line.reads << " "
+                     << line.writes << std::endl;
+            }
+        }
+        return file.good();
+    }
+}
@@ -0,0 +1,78 @@
+#include <wdb_tui/parallel_profiler.h>
+#include <wdb_tui/thread_pool.h>
+#include <algorithm>
+#include <chrono>
+
+namespace wdb {
+    ParallelProfiler::ParallelProfiler(wdb::WdbWabt *wdbWabt, wdb::WdbExecutor::Options options, int threads,
+                                       wdb::ModuleIndex *moduleIndex) {
+        m_wdbWabt = wdbWabt;
+        m_moduleIndex = moduleIndex ? moduleIndex : &m_ownModuleIndex;
+        m_options = options;
+        // Output of concurrent runs would interleave
+        m_options.outputStreamHandler = [](std::string text) {};
+        m_threads = threads > 0 ? threads : ThreadPool::getHardwareThreads();
+    }
+
+    std::vector<std::string> ParallelProfiler::getRunnableFunctions() {
+        buildIndex();
+        return m_moduleIndex->getRunnableNames();
+    }
+
+    void ParallelProfiler::buildIndex() {
+        if(!m_moduleIndex->isBuilt()) {
+            m_moduleIndex->build(m_wdbWabt->CreateWdbExecutor(m_options));
+        }
+    }
+
+    void ParallelProfiler::run(const std::vector<std::string> &functions) {
+        m_profile.reset();
+        m_runs.assign(functions.size(), Run());
+        // Workers only read the index
+        buildIndex();
+        auto start = std::chrono::steady_clock::now();
+        {
+            // Never start more workers than functions
+            ThreadPool pool(std::min(m_threads, std::max((int) functions.size(), 1)));
+            for(size_t i=0; i < functions.size(); i++) {
+                m_runs[i].function = functions[i];
+                Run *run = &m_runs[i];
+                pool.submit([this, run]() {
+                    profile(*run);
+                });
+            }
+            pool.wait();
+        }
+        m_wallTime = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+    }
+
+    void ParallelProfiler::profile(Run &run) {
+        wdb::WdbDebuggerExecutor *executor;
+        {
+            // Instantiation shares the loaded module
+            std::lock_guard<std::mutex> lock(m_mutex);
+            executor = m_wdbWabt->CreateWdbDebuggerExecutor(m_options);
+        }
+        if(!executor) {
+            return;
+        }
+        auto func = m_moduleIndex->getFunction(executor, run.function);
+        if(!func || executor->SetMainFunction(func) != wabt::Result::Ok) {
+            return;
+        }
+        wdb::Tracer tracer(executor, m_moduleIndex);
+        TimingProfile profile;
+        tracer.addListener(&profile);
+        auto start = std::chrono::steady_clock::now();
+        run.succeeded = tracer.run() == wabt::Result::Ok;
+        run.wallTime = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        run.instructions = tracer.getInstructionCount();
+        run.time = tracer.getElapsedTime();
+        if(run.succeeded) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_profile.merge(profile);
+        }
+    }
+}
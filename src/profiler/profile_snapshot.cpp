@@ -0,0 +1,214 @@
+#include <wdb_tui/profile_snapshot.h>
+#include <wdb_tui/json.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace wdb {
+    const int ProfileSnapshot::VERSION;
+    constexpr double ProfileSnapshot::MIN_TIME_SHARE;
+
+    namespace {
+        const char *FORMAT = "wdb-profile";
+
+        std::vector<ProfileSnapshot::Record> ToRecords(const std::vector<const TimingProfile::Entry*> &entries) {
+            std::vector<ProfileSnapshot::Record> records;
+            for(auto entry : entries) {
+                ProfileSnapshot::Record record;
+                record.name = entry->name;
+                record.count = entry->count;
+                record.totalTime = entry->totalTime;
+                record.instructions = entry->instructions;
+                records.push_back(record);
+            }
+            return records;
+        }
+
+        Json ToJson(const std::vector<ProfileSnapshot::Record> &records) {
+            Json array = Json::array();
+            for(auto &record : records) {
+                Json object = Json::object();
+                object["name"] = record.name;
+                object["count"] = record.count;
+                object["time_ns"] = record.totalTime;
+                if(record.instructions > 0) {
+                    object["instructions"] = record.instructions;
+                }
+                array.push(object);
+            }
+            return array;
+        }
+
+        bool FromJson(const Json &array, std::vector<ProfileSnapshot::Record> &records) {
+            if(!array.isArray()) {
+                return false;
+            }
+            records.clear();
+            for(auto &object : array.getArray()) {
+                if(!object.get("name").isString()) {
+                    return false;
+                }
+                ProfileSnapshot::Record record;
+                record.name = object.get("name").asString();
+                record.count = object.get("count").asUint();
+                record.totalTime = object.get("time_ns").asUint();
+                record.instructions = object.get("instructions").asUint();
+                records.push_back(record);
+            }
+            return true;
+        }
+    }
+
+    void ProfileSnapshot::capture(const std::string &function, const Tracer &tracer,
+                                  const TimingProfile &timingProfile, const CallGraphProfile &callGraphProfile) {
+        m_function = function;
+        m_instructionCount = tracer.getInstructionCount();
+        m_elapsedTime = tracer.getElapsedTime();
+        m_opcodes = ToRecords(timingProfile.getOpcodesSorted(WdbProfilerExecutor::Sort::OPCODE_ASC));
+        m_functions = ToRecords(timingProfile.getFunctionsSorted(WdbProfilerExecutor::Sort::OPCODE_ASC));
+        m_calls.clear();
+        for(auto &edge : callGraphProfile.getEdges()) {
+            Record record;
+            record.name = edge.caller + " -> " + edge.callee;
+            record.count = edge.count;
+            record.totalTime = edge.totalTime;
+            m_calls.push_back(record);
+        }
+    }
+
+    bool ProfileSnapshot::save(const std::string &fileName) const {
+        std::ofstream file(fileName);
+        if(!file.good()) {
+            return false;
+        }
+        Json root = Json::object();
+        root["format"] = FORMAT;
+        root["version"] = VERSION;
+        root["function"] = m_function;
+        root["instructions"] = m_instructionCount;
+        root["time_ns"] = m_elapsedTime;
+        root["opcodes"] = ToJson(m_opcodes);
+        root["functions"] = ToJson(m_functions);
+        root["calls"] = ToJson(m_calls);
+        file << root.dump(2) << std::endl;
+        return file.good();
+    }
+
+    bool ProfileSnapshot::load(const std::string &fileName, std::string &error) {
+        std::ifstream file(fileName);
+        if(!file.good()) {
+            error = "Error opening file: " + fileName;
+            return false;
+        }
+        std::stringstream text;
+        text << file.rdbuf();
+        Json root;
+        if(!Json::parse(text.str(), root) || root.get("format").asString() != FORMAT) {
+            error = "Not a profile file: " + fileName;
+            return false;
+        }
+        int version = (int) root.get("version").asInt();
+        if(version < 1 || version > VERSION) {
+            error = "Unsupported profile version " + std::to_string(version) + ": " + fileName;
+            return false;
+        }
+        m_function = root.get("function").asString();
+        m_instructionCount = root.get("instructions").asUint();
+        m_elapsedTime = root.get("time_ns").asUint();
+        if(!FromJson(root.get("opcodes"), m_opcodes) || !FromJson(root.get("functions"), m_functions)
+           || !FromJson(root.get("calls"), m_calls)) {
+            error = "Malformed profile file: " + fileName;
+            return false;
+        }
+        return true;
+    }
+
+    void ProfileSnapshot::diffRecords(const std::string &category, const std::vector<Record> &base,
+                                      const std::vector<Record> &current, std::vector<Delta> &deltas) {
+        std::unordered_map<std::string, size_t> index;
+        for(auto &record : base) {
+            Delta delta;
+            delta.category = category;
+            delta.name = record.name;
+            delta.base = record;
+            delta.inBase = true;
+            index[record.name] = deltas.size();
+            deltas.push_back(delta);
+        }
+        for(auto &record : current) {
+            auto match = index.find(record.name);
+            if(match != index.end()) {
+                deltas[match->second].current = record;
+                deltas[match->second].inCurrent = true;
+            } else {
+                Delta delta;
+                delta.category = category;
+                delta.name = record.name;
+                delta.current = record;
+                delta.inCurrent = true;
+                deltas.push_back(delta);
+            }
+        }
+    }
+
+    std::vector<ProfileSnapshot::Delta> ProfileSnapshot::diff(const ProfileSnapshot &base,
+                                                              const ProfileSnapshot &current) {
+        std::vector<Delta> deltas;
+        diffRecords("Opcode", base.m_opcodes, current.m_opcodes, deltas);
+        diffRecords("Function", base.m_functions, current.m_functions, deltas);
+        diffRecords("Call", base.m_calls, current.m_calls, deltas);
+        std::stable_sort(deltas.begin(), deltas.end(), [](const Delta &a, const Delta &b) {
+            if(a.getTimeDelta() != b.getTimeDelta()) {
+                return a.getTimeDelta() > b.getTimeDelta();
+            }
+            return a.getCountDelta() > b.getCountDelta();
+        });
+        return deltas;
+    }
+
+    std::vector<ProfileSnapshot::Check> ProfileSnapshot::compare(const ProfileSnapshot &base,
+                                                                 const ProfileSnapshot &current, double threshold) {
+        std::vector<Check> checks;
+        auto addCheck = [&checks, threshold](const std::string &name, const std::string &metric, uint64_t baseValue,
+                                             uint64_t currentValue) {
+            Check check;
+            check.name = name;
+            check.metric = metric;
+            check.base = baseValue;
+            check.current = currentValue;
+            // Any increase over zero would be infinite
+            check.regressed = baseValue > 0 && (double) currentValue > (double) baseValue * (1 + threshold / 100);
+            checks.push_back(check);
+        };
+        addCheck("<total>", "instructions", base.m_instructionCount, current.m_instructionCount);
+        addCheck("<total>", "time", base.m_elapsedTime, current.m_elapsedTime);
+        std::unordered_map<std::string, const Record*> currentFunctions;
+        for(auto &record : current.m_functions) {
+            currentFunctions[record.name] = &record;
+        }
+        for(auto &record : base.m_functions) {
+            auto match = currentFunctions.find(record.name);
+            if(match == currentFunctions.end()) {
+                Check check;
+                check.name = record.name;
+                check.metric = "instructions";
+                check.base = record.instructions;
+                check.missing = true;
+                checks.push_back(check);
+                continue;
+            }
+            addCheck(record.name, "instructions", record.instructions, match->second->instructions);
+            if(base.m_elapsedTime > 0 && 100.0 * record.totalTime / base.m_elapsedTime >= MIN_TIME_SHARE) {
+                addCheck(record.name, "time", record.totalTime, match->second->totalTime);
+            }
+        }
+        std::stable_sort(checks.begin(), checks.end(), [](const Check &a, const Check &b) {
+            if(a.regressed != b.regressed) {
+                return a.regressed > b.regressed;
+            }
+            return a.missing > b.missing;
+        });
+        return checks;
+    }
+}
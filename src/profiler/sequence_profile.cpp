@@ -0,0 +1,86 @@
+#include <wdb_tui/sequence_profile.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace wdb {
+    const int SequenceProfile::MAX_TRIPLE_OPCODES;
+
+    void SequenceProfile::reset() {
+        m_opcodeIds.clear();
+        m_opcodes.clear();
+        m_numOpcodes = 0;
+        m_pairs.clear();
+        m_triples.clear();
+        m_previous = -1;
+        m_beforePrevious = -1;
+        m_total = 0;
+        m_droppedTriples = 0;
+    }
+
+    void SequenceProfile::onStart(Tracer &tracer) {
+        reset();
+        // Map opcodes present in the module to dense ids
+        std::unordered_map<uint32_t, int> ids;
+        for(auto &instruction : tracer.getInstructions()) {
+            auto id = ids.find(instruction.opcode);
+            if(id == ids.end()) {
+                id = ids.emplace(instruction.opcode, (int) m_opcodes.size()).first;
+                m_opcodes.push_back(instruction.opcode);
+            }
+            m_opcodeIds.push_back(id->second);
+        }
+        // Reserve an id for instructions outside the module
+        m_unknownId = (int) m_opcodes.size();
+        m_opcodes.push_back(Tracer::getOpcodeCount());
+        m_numOpcodes = (int) m_opcodes.size();
+        // Allocate flat counters
+        m_pairs.assign((size_t) m_numOpcodes * m_numOpcodes, 0);
+        if(m_numOpcodes <= MAX_TRIPLE_OPCODES) {
+            m_triples.assign((size_t) m_numOpcodes * m_numOpcodes * m_numOpcodes, 0);
+        }
+    }
+
+    std::vector<SequenceProfile::Sequence> SequenceProfile::getTopPairs(int k) const {
+        return getTop(m_pairs, 2, k);
+    }
+
+    std::vector<SequenceProfile::Sequence> SequenceProfile::getTopTriples(int k) const {
+        return getTop(m_triples, 3, k);
+    }
+
+    std::vector<SequenceProfile::Sequence> SequenceProfile::getTop(const std::vector<uint64_t> &counters, int length,
+                                                                   int k) const {
+        // Collect non-zero counters
+        std::vector<size_t> indices;
+        for(size_t i=0; i < counters.size(); i++) {
+            if(counters[i] > 0) {
+                indices.push_back(i);
+            }
+        }
+        // Keep the k largest
+        size_t top = std::min(indices.size(), (size_t) std::max(k, 0));
+        std::partial_sort(indices.begin(), indices.begin() + top, indices.end(), [&counters](size_t a, size_t b) {
+            return counters[a] > counters[b];
+        });
+        // Decode flat index into opcode names
+        std::vector<Sequence> sequences;
+        for(size_t i=0; i < top; i++) {
+            Sequence sequence;
+            sequence.count = counters[indices[i]];
+            size_t flat = indices[i];
+            std::vector<std::string> names((size_t) length);
+            for(int j=length-1; j >= 0; j--) {
+                names[j] = Tracer::getOpcodeName(m_opcodes[flat % m_numOpcodes]);
+                flat /= m_numOpcodes;
+            }
+            for(int j=0; j < length; j++) {
+                if(j > 0) {
+                    sequence.name += " + ";
+                }
+                sequence.name += names[j];
+            }
+            sequences.push_back(sequence);
+        }
+        return sequences;
+    }
+}
@@ -0,0 +1,29 @@
+#include <wdb_tui/stack_profile.h>
+
+namespace wdb {
+    void StackProfile::reset() {
+        m_limitReached = false;
+        m_valueStack = HighWater();
+        m_callStack = HighWater();
+    }
+
+    void StackProfile::onCall(Tracer &tracer, int function, int callSite) {
+        int depth = tracer.getCallDepth();
+        if(depth > m_callStack.value) {
+            // Report the entered function and its entry pc
+            record(tracer, m_callStack, depth, -1);
+        }
+        // Stop runaway recursion before the interpreter stack overflows
+        if(m_callDepthLimit > 0 && depth > m_callDepthLimit && !m_limitReached) {
+            m_limitReached = true;
+            tracer.stop();
+        }
+    }
+
+    void StackProfile::record(Tracer &tracer, HighWater &highWater, int value, int index) {
+        highWater.value = value;
+        int function = tracer.getCurrentFunction();
+        highWater.function = function < 0 ? "<unknown>" : tracer.getFunction(function).name;
+        highWater.offset = index < 0 ? tracer.getExecutor()->GetPcOffset() : tracer.getInstruction(index).offset;
+    }
+}
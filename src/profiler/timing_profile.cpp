@@ -0,0 +1,116 @@
+#include <wdb_tui/timing_profile.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace wdb {
+    TimingProfile::TimingProfile() {
+        // Allocate opcode entries upfront so recording never allocates
+        m_opcodes.resize(Tracer::getOpcodeCount() + 1);
+        for(uint32_t i=0; i < m_opcodes.size(); i++) {
+            m_opcodes[i].name = Tracer::getOpcodeName(i);
+        }
+    }
+
+    void TimingProfile::reset() {
+        for(auto &entry : m_opcodes) {
+            entry.count = 0;
+            entry.totalTime = 0;
+            entry.instructions = 0;
+            entry.histogram.reset();
+        }
+        m_functions.clear();
+        m_callInstructions.clear();
+    }
+
+    void TimingProfile::merge(const TimingProfile &other) {
+        for(size_t i=0; i < m_opcodes.size(); i++) {
+            mergeEntry(m_opcodes[i], other.m_opcodes[i]);
+        }
+        std::unordered_map<std::string, size_t> functions;
+        for(size_t i=0; i < m_functions.size(); i++) {
+            functions[m_functions[i].name] = i;
+        }
+        for(auto &entry : other.m_functions) {
+            if(entry.count == 0) {
+                continue;
+            }
+            auto function = functions.find(entry.name);
+            if(function == functions.end()) {
+                functions[entry.name] = m_functions.size();
+                m_functions.push_back(entry);
+            } else {
+                mergeEntry(m_functions[function->second], entry);
+            }
+        }
+    }
+
+    void TimingProfile::mergeEntry(Entry &entry, const Entry &other) {
+        entry.count += other.count;
+        entry.totalTime += other.totalTime;
+        entry.instructions += other.instructions;
+        entry.histogram.merge(other.histogram);
+    }
+
+    void TimingProfile::onStart(Tracer &tracer) {
+        m_functions.clear();
+        m_callInstructions.clear();
+        m_functions.resize(tracer.getFunctions().size() + 1);
+        for(int i=0; i < tracer.getFunctions().size(); i++) {
+            m_functions[i].name = tracer.getFunction(i).name;
+        }
+        m_functions.back().name = "<unknown>";
+    }
+
+    void TimingProfile::onReturn(Tracer &tracer, int function, uint64_t time) {
+        Entry &entry = function < 0 ? m_functions.back() : m_functions[function];
+        entry.count++;
+        entry.totalTime += time;
+        entry.histogram.record(time);
+        if(!m_callInstructions.empty()) {
+            entry.instructions += tracer.getInstructionCount() - m_callInstructions.back();
+            m_callInstructions.pop_back();
+        }
+    }
+
+    std::vector<const TimingProfile::Entry*> TimingProfile::getOpcodesSorted(
+            wdb::WdbProfilerExecutor::Sort sort) const {
+        return sortEntries(m_opcodes, sort);
+    }
+
+    std::vector<const TimingProfile::Entry*> TimingProfile::getFunctionsSorted(
+            wdb::WdbProfilerExecutor::Sort sort) const {
+        return sortEntries(m_functions, sort);
+    }
+
+    std::vector<const TimingProfile::Entry*> TimingProfile::sortEntries(const std::vector<Entry> &entries,
+                                                                       wdb::WdbProfilerExecutor::Sort sort) {
+        std::vector<const Entry*> sorted;
+        for(auto &entry : entries) {
+            if(entry.count > 0) {
+                sorted.push_back(&entry);
+            }
+        }
+        std::sort(sorted.begin(), sorted.end(), [sort](const Entry *a, const Entry *b) {
+            switch (sort) {
+                case wdb::WdbProfilerExecutor::Sort::OPCODE_DESC:
+                    return a->name > b->name;
+                case wdb::WdbProfilerExecutor::Sort::TOTAL_COUNT_ASC:
+                    return a->count < b->count;
+                case wdb::WdbProfilerExecutor::Sort::TOTAL_COUNT_DESC:
+                    return a->count > b->count;
+                case wdb::WdbProfilerExecutor::Sort::TOTAL_TIME_ASC:
+                    return a->totalTime < b->totalTime;
+                case wdb::WdbProfilerExecutor::Sort::TOTAL_TIME_DESC:
+                    return a->totalTime > b->totalTime;
+                case wdb::WdbProfilerExecutor::Sort::AVG_TIME_ASC:
+                    return a->getAverageTime() < b->getAverageTime();
+                case wdb::WdbProfilerExecutor::Sort::AVG_TIME_DESC:
+                    return a->getAverageTime() > b->getAverageTime();
+                case wdb::WdbProfilerExecutor::Sort::OPCODE_ASC:
+                default:
+                    return a->name < b->name;
+            }
+        });
+        return sorted;
+    }
+}
@@ -0,0 +1,363 @@
+#include <wdb_tui/tracer.h>
+#include <wabt/src/cast.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+namespace wdb {
+    namespace {
+        std::unordered_map<std::string, uint32_t> BuildOpcodeNames() {
+            std::unordered_map<std::string, uint32_t> names;
+            for(uint32_t i=0; i < wabt::Opcode::Invalid; i++) {
+                names[wabt::Opcode(static_cast<wabt::Opcode::Enum>(i)).GetName()] = i;
+            }
+            return names;
+        }
+
+        /**
+         * Parse the number following a marker, e.g. '@' in "br @42"
+         */
+        bool ParseNumberAfter(const std::string &text, const std::string &marker, uint32_t &value) {
+            size_t pos = text.find(marker);
+            if(pos == std::string::npos) {
+                return false;
+            }
+            pos += marker.size();
+            if(pos >= text.size() || !std::isdigit(text[pos])) {
+                return false;
+            }
+            value = (uint32_t) std::strtoul(text.c_str() + pos, nullptr, 10);
+            return true;
+        }
+
+        uint8_t GetAccessSize(const std::string &name, size_t accessPos) {
+            std::string suffix = name.substr(accessPos);
+            if(suffix.compare(0, 1, "8") == 0) {
+                return 1;
+            } else if(suffix.compare(0, 2, "16") == 0) {
+                return 2;
+            } else if(suffix.compare(0, 2, "32") == 0) {
+                return 4;
+            } else if(name.compare(0, 3, "i64") == 0 || name.compare(0, 3, "f64") == 0) {
+                return 8;
+            } else if(name.compare(0, 4, "v128") == 0) {
+                return 16;
+            }
+            return 4;
+        }
+    }
+
+    Tracer::Tracer(wdb::WdbDebuggerExecutor *executor, wdb::ModuleIndex *moduleIndex) {
+        m_executor = executor;
+        // Decode module instructions
+        for(auto &instruction : m_executor->DisassembleModule(m_executor->GetMainModule())) {
+            m_instructions.push_back(decode(instruction));
+        }
+        buildFunctions(moduleIndex);
+        buildBlocks();
+        m_breakpoints.assign(m_instructions.size(), false);
+    }
+
+    Tracer::Instruction Tracer::decode(const wdb::WdbDebuggerExecutor::Instruction &instruction) {
+        static const std::unordered_map<std::string, uint32_t> opcodeNames = BuildOpcodeNames();
+        Instruction decoded;
+        decoded.offset = instruction.istream_start;
+        decoded.text = instruction.str;
+
+        // Skip the "<offset>| " prefix of the interpreter disassembly
+        std::string text = instruction.str;
+        size_t bar = text.find('|');
+        if(bar != std::string::npos && text.find_first_not_of(" 0123456789") == bar) {
+            text = text.substr(bar + 1);
+        }
+        std::istringstream ss(text);
+        std::string name;
+        std::string operands;
+        ss >> name;
+        std::getline(ss, operands);
+
+        auto opcode = opcodeNames.find(name);
+        if(opcode != opcodeNames.end()) {
+            decoded.opcode = opcode->second;
+        }
+
+        // Classify instruction, operands follow the interpreter disassembly:
+        // "i32.load $<memory>:%[-1]+$<offset>", "br_if @<target>", "call @<target>"
+        size_t accessPos;
+        if((accessPos = name.find(".load")) != std::string::npos) {
+            decoded.kind = LOAD;
+            decoded.accessSize = GetAccessSize(name, accessPos + 5);
+        } else if((accessPos = name.find(".store")) != std::string::npos) {
+            decoded.kind = STORE;
+            decoded.accessSize = GetAccessSize(name, accessPos + 6);
+        } else if(name == "memory.grow" || name == "grow_memory") {
+            decoded.kind = MEMORY_GROW;
+        } else if(name == "br" || name == "br_if" || name == "br_unless" || name == "br_table") {
+            decoded.kind = BRANCH;
+            // br_table lists every target
+            for(size_t pos = operands.find('@'); pos != std::string::npos; pos = operands.find('@', pos + 1)) {
+                uint32_t target;
+                if(ParseNumberAfter(operands.substr(pos), "@", target)) {
+                    decoded.targets.push_back(target);
+                }
+            }
+            if(!decoded.targets.empty()) {
+                decoded.immediate = decoded.targets.front();
+            }
+        } else if(name == "call") {
+            decoded.kind = CALL;
+            ParseNumberAfter(operands, "@", decoded.immediate);
+        } else if(name == "call_indirect") {
+            // Target comes from the table at runtime, the callee is found from the pc after the call
+            decoded.kind = CALL;
+        } else if(name == "call_host") {
+            decoded.kind = CALL_HOST;
+        } else if(name == "return") {
+            decoded.kind = RETURN;
+        } else if(name == "unreachable") {
+            decoded.kind = UNREACHABLE;
+        }
+        if(decoded.kind == LOAD || decoded.kind == STORE || decoded.kind == MEMORY_GROW) {
+            ParseNumberAfter(operands, "$", decoded.memory);
+            ParseNumberAfter(operands, "+$", decoded.immediate);
+        }
+        return decoded;
+    }
+
+    void Tracer::buildFunctions(wdb::ModuleIndex *moduleIndex) {
+        if(m_instructions.empty()) {
+            return;
+        }
+        struct Entry {
+            std::string name;
+            int index = -1;
+        };
+        std::map<uint32_t, Entry> entries;
+        entries[m_instructions.front().offset] = Entry();
+        // Direct calls land on function entries
+        for(auto &instruction : m_instructions) {
+            if(instruction.kind == CALL && getInstructionIndex(instruction.immediate) >= 0) {
+                entries[instruction.immediate];
+            }
+        }
+        // All defined functions, including those only reached through a table
+        if(moduleIndex) {
+            moduleIndex->build(m_executor);
+        }
+        if(moduleIndex && moduleIndex->hasDefinedFunctions()) {
+            for(wabt::Index i=0; i < moduleIndex->getDefinedFunctionCount(); i++) {
+                auto func = moduleIndex->getDefinedFunction(m_executor, i);
+                if(!func || func->is_host) {
+                    continue;
+                }
+                uint32_t offset = wabt::cast<wabt::interp::DefinedFunc>(func)->offset;
+                if(getInstructionIndex(offset) >= 0) {
+                    Entry &entry = entries[offset];
+                    entry.index = (int) (moduleIndex->getImportedFunctionCount() + i);
+                    entry.name = moduleIndex->getFunctionName((wabt::Index) entry.index);
+                }
+            }
+        }
+        // Export names win over the name section, they are the names given on the command line
+        for(auto &e : m_executor->GetExportedModuleFunctions(m_executor->GetMainModule())) {
+            auto func = m_executor->GetFunction(e.index);
+            if(func && !func->is_host) {
+                uint32_t offset = wabt::cast<wabt::interp::DefinedFunc>(func)->offset;
+                if(getInstructionIndex(offset) >= 0) {
+                    entries[offset].name = e.name;
+                }
+            }
+        }
+        // Split instructions at function entries
+        for(auto &entry : entries) {
+            Function function;
+            function.offset = entry.first;
+            function.index = entry.second.index;
+            function.name = entry.second.name;
+            if(function.name.empty()) {
+                // Module indices survive a rebuild that moves code, offsets do not
+                function.name = function.index >= 0 ? "func#" + std::to_string(function.index)
+                                                     : "func@" + std::to_string(entry.first);
+            }
+            function.firstInstruction = getInstructionIndex(entry.first);
+            if(!m_functions.empty()) {
+                m_functions.back().endInstruction = function.firstInstruction;
+            }
+            m_functions.push_back(function);
+        }
+        m_functions.back().endInstruction = (int) m_instructions.size();
+        for(int i=0; i < m_functions.size(); i++) {
+            for(int j=m_functions[i].firstInstruction; j < m_functions[i].endInstruction; j++) {
+                m_instructions[j].function = i;
+            }
+        }
+    }
+
+    void Tracer::buildBlocks() {
+        if(m_instructions.empty()) {
+            return;
+        }
+        // Blocks start at function entries, branch targets and after control transfers
+        for(auto &function : m_functions) {
+            m_instructions[function.firstInstruction].blockStart = true;
+        }
+        for(int i=0; i < m_instructions.size(); i++) {
+            auto &instruction = m_instructions[i];
+            switch (instruction.kind) {
+                case BRANCH: {
+                    for(uint32_t offset : instruction.targets) {
+                        int target = getInstructionIndex(offset);
+                        if(target >= 0) {
+                            m_instructions[target].blockStart = true;
+                        }
+                    }
+                }
+                // Fall through
+                case CALL:
+                case CALL_HOST:
+                case RETURN:
+                case UNREACHABLE:
+                    if(i + 1 < m_instructions.size()) {
+                        m_instructions[i + 1].blockStart = true;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        // Number blocks
+        m_blockCount = 0;
+        for(auto &instruction : m_instructions) {
+            if(instruction.blockStart) {
+                m_blockCount++;
+            }
+            instruction.block = m_blockCount - 1;
+        }
+    }
+
+    int Tracer::getInstructionIndex(uint32_t offset) {
+        // Execution is mostly sequential, try the next instruction first
+        int next = m_lastIndex + 1;
+        if(next >= 0 && next < m_instructions.size() && m_instructions[next].offset == offset) {
+            return m_lastIndex = next;
+        }
+        auto it = std::lower_bound(m_instructions.begin(), m_instructions.end(), offset,
+                                   [](const Instruction &instruction, uint32_t value) {
+                                       return instruction.offset < value;
+                                   });
+        if(it == m_instructions.end() || it->offset != offset) {
+            return -1;
+        }
+        return m_lastIndex = (int) (it - m_instructions.begin());
+    }
+
+    std::string Tracer::getOpcodeName(uint32_t opcode) {
+        if(opcode >= getOpcodeCount()) {
+            return "<unknown>";
+        }
+        return wabt::Opcode(static_cast<wabt::Opcode::Enum>(opcode)).GetName();
+    }
+
+    void Tracer::start() {
+        m_started = true;
+        for(auto listener : m_listeners) {
+            listener->onStart(*this);
+        }
+        enterFunction(-1);
+    }
+
+    void Tracer::enterFunction(int callSite) {
+        int index = getInstructionIndex(m_executor->GetPcOffset());
+        int function = index < 0 ? -1 : m_instructions[index].function;
+        if(function >= 0 && m_functions[function].firstInstruction != index) {
+            function = -1;
+        }
+        m_callStack.push_back({function, m_elapsedTime});
+        for(auto listener : m_listeners) {
+            listener->onCall(*this, function, callSite);
+        }
+    }
+
+    void Tracer::leaveFunction() {
+        if(m_callStack.empty()) {
+            return;
+        }
+        Frame frame = m_callStack.back();
+        m_callStack.pop_back();
+        for(auto listener : m_listeners) {
+            listener->onReturn(*this, frame.function, m_elapsedTime - frame.startTime);
+        }
+    }
+
+    wabt::Result Tracer::step() {
+        if(!m_started) {
+            start();
+        }
+        int index = getInstructionIndex(m_executor->GetPcOffset());
+        for(auto listener : m_listeners) {
+            listener->onBeforeInstruction(*this, index);
+        }
+        // Time the instruction alone
+        uint64_t time = 0;
+        wabt::Result result;
+        if(m_timed) {
+            auto startTime = std::chrono::steady_clock::now();
+            result = m_executor->ExecuteNextInstruction();
+            time = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+        } else {
+            result = m_executor->ExecuteNextInstruction();
+        }
+        if(result != wabt::Result::Ok) {
+            return result;
+        }
+        m_instructionCount++;
+        m_elapsedTime += time;
+        for(auto listener : m_listeners) {
+            listener->onAfterInstruction(*this, index, time);
+        }
+        // Follow calls and returns
+        if(index >= 0) {
+            if(m_instructions[index].kind == CALL) {
+                // A host function reached through call_indirect returns inline, there is no frame to push
+                if(getInstructionIndex(m_executor->GetPcOffset()) != index + 1) {
+                    enterFunction(index);
+                }
+            } else if(m_instructions[index].kind == RETURN) {
+                leaveFunction();
+            }
+        }
+        // Notify once the main function is done
+        if(!m_finished && m_executor->MainFunctionHasReturned()) {
+            m_finished = true;
+            for(auto listener : m_listeners) {
+                listener->onFinish(*this);
+            }
+        }
+        return wabt::Result::Ok;
+    }
+
+    wabt::Result Tracer::run() {
+        while(!m_executor->MainFunctionHasReturned()) {
+            if(step() != wabt::Result::Ok || m_stopped) {
+                return wabt::Result::Error;
+            }
+            // Stop before the next instruction if it has a breakpoint
+            int next = getInstructionIndex(m_executor->GetPcOffset());
+            if(next >= 0 && m_breakpoints[next]) {
+                break;
+            }
+        }
+        return wabt::Result::Ok;
+    }
+
+    void Tracer::setBreakpoint(int index, bool enabled) {
+        if(index >= 0 && index < m_breakpoints.size()) {
+            m_breakpoints[index] = enabled;
+        }
+    }
+}
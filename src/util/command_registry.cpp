@@ -0,0 +1,183 @@
+#include <wdb_tui/command_registry.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace wdb {
+    void CommandRegistry::add(const Command &command) {
+        auto existing = m_index.find(command.name);
+        size_t index = existing == m_index.end() ? m_commands.size() : existing->second;
+        if(index == m_commands.size()) {
+            m_commands.push_back(command);
+        } else {
+            m_commands[index] = command;
+        }
+        m_index[command.name] = index;
+        for(auto &alias : command.aliases) {
+            m_index[alias] = index;
+        }
+    }
+
+    CommandRegistry::Status CommandRegistry::execute(const std::string &line, std::string &error) const {
+        std::vector<std::string> words = split(line);
+        if(words.empty()) {
+            return EMPTY;
+        }
+        auto entry = m_index.find(words[0]);
+        if(entry == m_index.end()) {
+            error = "Command '" + line + "' not found";
+            return NOT_FOUND;
+        }
+        const Command &command = m_commands[entry->second];
+        if(words.size() - 1 != command.arguments.size()) {
+            error = "Usage: " + command.name + (command.usage.empty() ? "" : " " + command.usage);
+            return INVALID_ARGUMENTS;
+        }
+        // Check arguments before running the handler
+        std::vector<Argument> arguments(command.arguments.size());
+        for(size_t i=0; i < command.arguments.size(); i++) {
+            Argument &argument = arguments[i];
+            argument.text = words[i + 1];
+            switch(command.arguments[i]) {
+                case LINE:
+                    if(!parseLine(argument.text, argument.number)) {
+                        error = "Invalid line number '" + argument.text + "'";
+                        return INVALID_ARGUMENTS;
+                    }
+                    break;
+                case LOCATION:
+                    if(!parseLocation(argument.text, argument.location)) {
+                        error = "Invalid location '" + argument.text + "', please type 'help' for the format";
+                        return INVALID_ARGUMENTS;
+                    }
+                    break;
+                case NAME:
+                    break;
+            }
+        }
+        command.handler(arguments);
+        return EXECUTED;
+    }
+
+    std::string CommandRegistry::complete(const std::string &line, std::vector<std::string> &candidates) const {
+        candidates.clear();
+        std::vector<std::string> words = split(line);
+        // Word being typed, empty after a separator
+        bool newWord = line.empty() || line.back() == ' ' || line.back() == '\t';
+        std::string prefix = newWord || words.empty() ? "" : words.back();
+        size_t position = newWord ? words.size() : words.size() - 1;
+        if(position == 0) {
+            for(auto &entry : m_index) {
+                candidates.push_back(entry.first);
+            }
+        } else {
+            auto entry = m_index.find(words[0]);
+            if(entry != m_index.end()) {
+                const Command &command = m_commands[entry->second];
+                if(position <= command.arguments.size() && command.arguments[position - 1] == NAME) {
+                    candidates = m_names;
+                }
+            }
+        }
+        // Keep words starting with the prefix
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&prefix](const std::string &word) {
+            return word.compare(0, prefix.size(), prefix) != 0;
+        }), candidates.end());
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        if(candidates.empty()) {
+            return line;
+        }
+        // Extend the prefix as far as all candidates agree
+        std::string common = candidates.front();
+        for(auto &candidate : candidates) {
+            size_t length = 0;
+            while(length < common.size() && length < candidate.size() && common[length] == candidate[length]) {
+                length++;
+            }
+            common.resize(length);
+        }
+        std::string completed = line.substr(0, line.size() - prefix.size()) + common;
+        if(candidates.size() == 1) {
+            completed += " ";
+        }
+        return completed;
+    }
+
+    std::vector<std::string> CommandRegistry::getHelp() const {
+        std::vector<std::string> lines;
+        for(auto &command : m_commands) {
+            std::string name = command.name;
+            for(auto &alias : command.aliases) {
+                name += "|" + alias;
+            }
+            std::stringstream ss;
+            ss << "  " << std::left << std::setw(11) << name << " " << std::setw(15) << command.usage << " "
+               << command.help;
+            lines.push_back(ss.str());
+        }
+        return lines;
+    }
+
+    std::vector<std::string> CommandRegistry::split(const std::string &line) {
+        std::vector<std::string> words;
+        size_t i = 0;
+        while(i < line.size()) {
+            while(i < line.size() && (line[i] == ' ' || line[i] == '\t')) {
+                i++;
+            }
+            size_t start = i;
+            while(i < line.size() && line[i] != ' ' && line[i] != '\t') {
+                i++;
+            }
+            if(i > start) {
+                words.push_back(line.substr(start, i - start));
+            }
+        }
+        return words;
+    }
+
+    bool CommandRegistry::parseLine(const std::string &text, uint64_t &number) {
+        if(text.empty() || text.size() > 9 || text[0] == '0') {
+            return false;
+        }
+        number = 0;
+        for(char c : text) {
+            if(c < '0' || c > '9') {
+                return false;
+            }
+            number = number * 10 + (uint64_t) (c - '0');
+        }
+        return true;
+    }
+
+    bool CommandRegistry::parseLocation(const std::string &text, Location &location) {
+        size_t open = text.find('[');
+        size_t close = text.find("].", open == std::string::npos ? 0 : open);
+        if(open == std::string::npos || close == std::string::npos) {
+            return false;
+        }
+        location.space = text.substr(0, open);
+        location.type = text.substr(close + 2);
+        if(location.space != "stack" && location.space != "memo") {
+            return false;
+        }
+        if(location.type != "i32" && location.type != "i64" && location.type != "f32" && location.type != "f64"
+           && location.type != "v128") {
+            return false;
+        }
+        // Index has at most five digits
+        size_t digits = close - open - 1;
+        if(digits == 0 || digits > 5) {
+            return false;
+        }
+        location.index = 0;
+        for(size_t i=open+1; i < close; i++) {
+            if(text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+            location.index = location.index * 10 + (uint32_t) (text[i] - '0');
+        }
+        return true;
+    }
+}
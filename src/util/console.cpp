@@ -0,0 +1,94 @@
+#include <wdb_tui/console.h>
+#include <algorithm>
+
+namespace wdb {
+    const size_t Console::DEFAULT_CAPACITY;
+    const size_t Console::MAX_LINE_LENGTH;
+
+    Console::Console(size_t capacity) : m_lines(std::max(capacity, (size_t) 1)) {}
+
+    Console::~Console() {
+        closeLine();
+    }
+
+    void Console::write(const std::string &text) {
+        size_t start = 0;
+        while(start < text.size()) {
+            size_t newline = text.find('\n', start);
+            size_t end = newline == std::string::npos ? text.size() : newline;
+            // Continue the open line or start a new one
+            std::string &line = m_open ? m_lines[(m_first + m_size - 1) % m_lines.size()] : pushLine();
+            // Wrap what does not fit onto the next line
+            size_t length = std::min(end - start, MAX_LINE_LENGTH - line.size());
+            line.append(text, start, length);
+            start += length;
+            if(start == end && newline == std::string::npos && line.size() < MAX_LINE_LENGTH) {
+                m_open = true;
+                break;
+            }
+            // The line is complete
+            m_open = false;
+            spill(line);
+            if(start == end) {
+                start = newline == std::string::npos ? text.size() : newline + 1;
+            }
+        }
+    }
+
+    void Console::addLine(const std::string &line) {
+        closeLine();
+        spill(pushLine() = line);
+    }
+
+    void Console::clear() {
+        closeLine();
+        for(size_t i=0; i < m_size; i++) {
+            m_lines[(m_first + i) % m_lines.size()].clear();
+        }
+        m_first = 0;
+        m_size = 0;
+        m_open = false;
+    }
+
+    bool Console::setSpillFile(const std::string &fileName) {
+        m_spill.close();
+        m_spill.open(fileName, std::ios::out | std::ios::app);
+        return m_spill.is_open();
+    }
+
+    std::vector<std::string> Console::getLines(size_t first, size_t count) const {
+        std::vector<std::string> lines;
+        for(size_t i=first; i < m_size && i - first < count; i++) {
+            lines.push_back(getLine(i));
+        }
+        return lines;
+    }
+
+    void Console::closeLine() {
+        if(m_open) {
+            m_open = false;
+            spill(m_lines[(m_first + m_size - 1) % m_lines.size()]);
+        }
+    }
+
+    void Console::spill(const std::string &line) {
+        if(m_spill.is_open()) {
+            m_spill << line << '\n';
+        }
+    }
+
+    std::string& Console::pushLine() {
+        if(m_size == m_lines.size()) {
+            // Drop the oldest line and reuse its slot
+            std::string &oldest = m_lines[m_first];
+            oldest.clear();
+            m_first = (m_first + 1) % m_lines.size();
+            m_dropped++;
+            return oldest;
+        }
+        m_size++;
+        std::string &line = m_lines[(m_first + m_size - 1) % m_lines.size()];
+        line.clear();
+        return line;
+    }
+}
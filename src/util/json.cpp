@@ -0,0 +1,401 @@
+#include <wdb_tui/json.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace wdb {
+    namespace {
+        class Parser {
+        public:
+            explicit Parser(const std::string &text) : m_text(text) {}
+
+            bool parseDocument(Json &value) {
+                if(!parseValue(value, 0)) {
+                    return false;
+                }
+                skipWhitespace();
+                return m_pos == m_text.size();
+            }
+        private:
+            // Guard against stack exhaustion on hostile input
+            static const int MAX_DEPTH = 256;
+            const std::string &m_text;
+            size_t m_pos = 0;
+
+            void skipWhitespace() {
+                while(m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t'
+                                                || m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+                    m_pos++;
+                }
+            }
+
+            bool consume(const char *literal) {
+                size_t length = std::char_traits<char>::length(literal);
+                if(m_text.compare(m_pos, length, literal) != 0) {
+                    return false;
+                }
+                m_pos += length;
+                return true;
+            }
+
+            bool parseValue(Json &value, int depth) {
+                if(depth > MAX_DEPTH) {
+                    return false;
+                }
+                skipWhitespace();
+                if(m_pos >= m_text.size()) {
+                    return false;
+                }
+                char c = m_text[m_pos];
+                if(c == '{') {
+                    return parseObject(value, depth);
+                } else if(c == '[') {
+                    return parseArray(value, depth);
+                } else if(c == '"') {
+                    std::string text;
+                    if(!parseString(text)) {
+                        return false;
+                    }
+                    value = Json(text);
+                    return true;
+                } else if(consume("true")) {
+                    value = Json(true);
+                    return true;
+                } else if(consume("false")) {
+                    value = Json(false);
+                    return true;
+                } else if(consume("null")) {
+                    value = Json();
+                    return true;
+                }
+                return parseNumber(value);
+            }
+
+            bool parseObject(Json &value, int depth) {
+                value = Json::object();
+                m_pos++;
+                skipWhitespace();
+                if(consume("}")) {
+                    return true;
+                }
+                while(true) {
+                    skipWhitespace();
+                    std::string key;
+                    if(m_pos >= m_text.size() || m_text[m_pos] != '"' || !parseString(key)) {
+                        return false;
+                    }
+                    skipWhitespace();
+                    if(!consume(":") || !parseValue(value[key], depth + 1)) {
+                        return false;
+                    }
+                    skipWhitespace();
+                    if(consume("}")) {
+                        return true;
+                    }
+                    if(!consume(",")) {
+                        return false;
+                    }
+                }
+            }
+
+            bool parseArray(Json &value, int depth) {
+                value = Json::array();
+                m_pos++;
+                skipWhitespace();
+                if(consume("]")) {
+                    return true;
+                }
+                while(true) {
+                    Json element;
+                    if(!parseValue(element, depth + 1)) {
+                        return false;
+                    }
+                    value.push(element);
+                    skipWhitespace();
+                    if(consume("]")) {
+                        return true;
+                    }
+                    if(!consume(",")) {
+                        return false;
+                    }
+                }
+            }
+
+            bool parseHex(uint32_t &code) {
+                if(m_pos + 4 > m_text.size()) {
+                    return false;
+                }
+                code = 0;
+                for(int i=0; i < 4; i++) {
+                    char c = m_text[m_pos++];
+                    code <<= 4;
+                    if(c >= '0' && c <= '9') {
+                        code |= c - '0';
+                    } else if(c >= 'a' && c <= 'f') {
+                        code |= c - 'a' + 10;
+                    } else if(c >= 'A' && c <= 'F') {
+                        code |= c - 'A' + 10;
+                    } else {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static void appendUtf8(std::string &text, uint32_t code) {
+                if(code < 0x80) {
+                    text += (char) code;
+                } else if(code < 0x800) {
+                    text += (char) (0xC0 | (code >> 6));
+                    text += (char) (0x80 | (code & 0x3F));
+                } else if(code < 0x10000) {
+                    text += (char) (0xE0 | (code >> 12));
+                    text += (char) (0x80 | ((code >> 6) & 0x3F));
+                    text += (char) (0x80 | (code & 0x3F));
+                } else {
+                    text += (char) (0xF0 | (code >> 18));
+                    text += (char) (0x80 | ((code >> 12) & 0x3F));
+                    text += (char) (0x80 | ((code >> 6) & 0x3F));
+                    text += (char) (0x80 | (code & 0x3F));
+                }
+            }
+
+            bool parseString(std::string &text) {
+                m_pos++;
+                while(m_pos < m_text.size()) {
+                    char c = m_text[m_pos++];
+                    if(c == '"') {
+                        return true;
+                    }
+                    if(c != '\\') {
+                        text += c;
+                        continue;
+                    }
+                    if(m_pos >= m_text.size()) {
+                        return false;
+                    }
+                    c = m_text[m_pos++];
+                    switch (c) {
+                        case '"':
+                        case '\\':
+                        case '/':
+                            text += c;
+                            break;
+                        case 'b':
+                            text += '\b';
+                            break;
+                        case 'f':
+                            text += '\f';
+                            break;
+                        case 'n':
+                            text += '\n';
+                            break;
+                        case 'r':
+                            text += '\r';
+                            break;
+                        case 't':
+                            text += '\t';
+                            break;
+                        case 'u': {
+                            uint32_t code;
+                            if(!parseHex(code)) {
+                                return false;
+                            }
+                            // Combine surrogate pairs
+                            if(code >= 0xD800 && code < 0xDC00 && consume("\\u")) {
+                                uint32_t low;
+                                if(!parseHex(low) || low < 0xDC00 || low >= 0xE000) {
+                                    return false;
+                                }
+                                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            appendUtf8(text, code);
+                            break;
+                        }
+                        default:
+                            return false;
+                    }
+                }
+                return false;
+            }
+
+            bool skipDigits() {
+                size_t start = m_pos;
+                while(m_pos < m_text.size() && m_text[m_pos] >= '0' && m_text[m_pos] <= '9') {
+                    m_pos++;
+                }
+                return m_pos > start;
+            }
+
+            bool parseNumber(Json &value) {
+                // Check the JSON grammar first, strtod also accepts nan, inf and hex floats
+                size_t start = m_pos;
+                consume("-");
+                if(!consume("0") && !skipDigits()) {
+                    return false;
+                }
+                if(consume(".") && !skipDigits()) {
+                    return false;
+                }
+                if(consume("e") || consume("E")) {
+                    if(!consume("+")) {
+                        consume("-");
+                    }
+                    if(!skipDigits()) {
+                        return false;
+                    }
+                }
+                double number = std::strtod(m_text.substr(start, m_pos - start).c_str(), nullptr);
+                if(std::isinf(number)) {
+                    return false;
+                }
+                value = Json(number);
+                return true;
+            }
+        };
+
+        void DumpString(std::string &out, const std::string &text) {
+            out += '"';
+            for(char c : text) {
+                switch (c) {
+                    case '"':
+                        out += "\\\"";
+                        break;
+                    case '\\':
+                        out += "\\\\";
+                        break;
+                    case '\n':
+                        out += "\\n";
+                        break;
+                    case '\r':
+                        out += "\\r";
+                        break;
+                    case '\t':
+                        out += "\\t";
+                        break;
+                    default:
+                        if((unsigned char) c < 0x20) {
+                            char escaped[8];
+                            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                            out += escaped;
+                        } else {
+                            out += c;
+                        }
+                        break;
+                }
+            }
+            out += '"';
+        }
+
+        void DumpNewline(std::string &out, int indent, int level) {
+            if(indent > 0) {
+                out += '\n';
+                out.append((size_t) indent * level, ' ');
+            }
+        }
+    }
+
+    bool Json::parse(const std::string &text, Json &value) {
+        Parser parser(text);
+        return parser.parseDocument(value);
+    }
+
+    int64_t Json::asInt() const {
+        double number = asNumber();
+        // 2^63 is exact in a double, casting anything outside [-2^63, 2^63) is undefined
+        if(std::isnan(number)) {
+            return 0;
+        }
+        if(number >= 9223372036854775808.0) {
+            return INT64_MAX;
+        }
+        if(number <= -9223372036854775808.0) {
+            return INT64_MIN;
+        }
+        return (int64_t) number;
+    }
+
+    uint64_t Json::asUint() const {
+        double number = asNumber();
+        // NaN fails the comparison too
+        if(!(number > 0)) {
+            return 0;
+        }
+        if(number >= 18446744073709551616.0) {
+            return UINT64_MAX;
+        }
+        return (uint64_t) number;
+    }
+
+    const Json& Json::get(const std::string &key) const {
+        static const Json null;
+        auto member = m_object.find(key);
+        return member == m_object.end() ? null : member->second;
+    }
+
+    std::string Json::dump(int indent) const {
+        std::string out;
+        dump(out, indent, 0);
+        return out;
+    }
+
+    void Json::dump(std::string &out, int indent, int level) const {
+        switch (m_type) {
+            case NUL:
+                out += "null";
+                break;
+            case BOOL:
+                out += m_bool ? "true" : "false";
+                break;
+            case NUMBER: {
+                char number[32];
+                // Keep integers exact instead of using exponent notation
+                if(std::floor(m_number) == m_number && std::fabs(m_number) < 1e18) {
+                    std::snprintf(number, sizeof(number), "%lld", (long long) m_number);
+                } else if(std::isfinite(m_number)) {
+                    std::snprintf(number, sizeof(number), "%.17g", m_number);
+                } else {
+                    std::snprintf(number, sizeof(number), "null");
+                }
+                out += number;
+                break;
+            }
+            case STRING:
+                DumpString(out, m_string);
+                break;
+            case ARRAY:
+                out += '[';
+                for(size_t i=0; i < m_array.size(); i++) {
+                    if(i > 0) {
+                        out += indent > 0 ? "," : ", ";
+                    }
+                    DumpNewline(out, indent, level + 1);
+                    m_array[i].dump(out, indent, level + 1);
+                }
+                if(!m_array.empty()) {
+                    DumpNewline(out, indent, level);
+                }
+                out += ']';
+                break;
+            case OBJECT: {
+                out += '{';
+                bool first = true;
+                for(auto &member : m_object) {
+                    if(!first) {
+                        out += indent > 0 ? "," : ", ";
+                    }
+                    first = false;
+                    DumpNewline(out, indent, level + 1);
+                    DumpString(out, member.first);
+                    out += ": ";
+                    member.second.dump(out, indent, level + 1);
+                }
+                if(!m_object.empty()) {
+                    DumpNewline(out, indent, level);
+                }
+                out += '}';
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#include <wdb_tui/mapped_file.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wdb {
+    MappedFile::MappedFile(const std::string &fileName) {
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if(fd < 0) {
+            return;
+        }
+        struct stat status;
+        if(fstat(fd, &status) == 0 && S_ISREG(status.st_mode)) {
+            m_open = true;
+            m_size = (size_t) status.st_size;
+            // Zero-length mappings are invalid
+            if(m_size > 0) {
+                void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if(data == MAP_FAILED) {
+                    m_open = false;
+                    m_size = 0;
+                } else {
+                    // Modules are read front to back
+                    madvise(data, m_size, MADV_SEQUENTIAL);
+                    m_data = static_cast<const uint8_t*>(data);
+                }
+            }
+        }
+        // The mapping stays valid after the descriptor is closed
+        close(fd);
+    }
+
+    MappedFile::~MappedFile() {
+        if(m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+    }
+}
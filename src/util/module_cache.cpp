@@ -0,0 +1,131 @@
+#include <wdb_tui/module_cache.h>
+#include <wdb_tui/mapped_file.h>
+#include <wdb_tui/xxhash.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Set by the build from the wabt-debugger revision
+#ifndef WDB_LOADER_VERSION
+#define WDB_LOADER_VERSION "unknown"
+#endif
+
+namespace wdb {
+    const int ModuleCache::VERSION;
+
+    namespace {
+        /**
+         * Create a directory and its parents
+         * @param path
+         * @return true if the directory exists afterwards
+         */
+        bool MakeDirectories(const std::string &path) {
+            for(size_t slash = path.find('/', 1); ; slash = path.find('/', slash + 1)) {
+                std::string prefix = path.substr(0, slash);
+                if(mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+                    return false;
+                }
+                if(slash == std::string::npos) {
+                    return true;
+                }
+            }
+        }
+
+        /**
+         * Format a hash as a key, results of another loader never match
+         * @param data
+         * @param size
+         * @return key
+         */
+        std::string ToKey(const void *data, size_t size) {
+            const char *version = ModuleCache::getLoaderVersion();
+            char key[17];
+            std::snprintf(key, sizeof(key), "%016llx",
+                          (unsigned long long) XxHash64(data, size, XxHash64(version, std::strlen(version))));
+            return key;
+        }
+    }
+
+    ModuleCache::ModuleCache(const std::string &directory) : m_directory(directory) {}
+
+    std::string ModuleCache::getDefaultDirectory() {
+        const char *cacheHome = std::getenv("XDG_CACHE_HOME");
+        if(cacheHome && cacheHome[0] == '/') {
+            return std::string(cacheHome) + "/wdb_tui";
+        }
+        const char *home = std::getenv("HOME");
+        if(home && home[0] != '\0') {
+            return std::string(home) + "/.cache/wdb_tui";
+        }
+        return "";
+    }
+
+    const char* ModuleCache::getLoaderVersion() {
+        return WDB_LOADER_VERSION;
+    }
+
+    std::string ModuleCache::getKey(const uint8_t *data, size_t size) {
+        return ToKey(data, size);
+    }
+
+    std::string ModuleCache::getFileKey(const std::string &fileName) {
+        struct stat status;
+        if(stat(fileName.c_str(), &status) != 0) {
+            return "";
+        }
+        // A rewritten file gets a new modification time or size
+        std::string identity = fileName + "\n" + std::to_string(status.st_dev) + ":" + std::to_string(status.st_ino)
+                               + ":" + std::to_string(status.st_size) + ":" + std::to_string(status.st_mtim.tv_sec)
+                               + "." + std::to_string(status.st_mtim.tv_nsec);
+        return "f" + ToKey(identity.data(), identity.size());
+    }
+
+    std::string ModuleCache::getPath(const std::string &key, const std::string &name) const {
+        return m_directory + "/" + key + ".v" + std::to_string(VERSION) + "." + name;
+    }
+
+    bool ModuleCache::isInvalid(const std::string &key, std::string &error) const {
+        return loadText(key, "invalid", error);
+    }
+
+    void ModuleCache::setInvalid(const std::string &key, const std::string &error) {
+        saveText(key, "invalid", error);
+    }
+
+    bool ModuleCache::loadText(const std::string &key, const std::string &name, std::string &text) const {
+        if(!isEnabled() || key.empty()) {
+            return false;
+        }
+        MappedFile file(getPath(key, name));
+        if(!file.isOpen()) {
+            return false;
+        }
+        text.assign(reinterpret_cast<const char*>(file.getData()), file.getSize());
+        return true;
+    }
+
+    bool ModuleCache::saveText(const std::string &key, const std::string &name, const std::string &text) {
+        if(!isEnabled() || key.empty() || !MakeDirectories(m_directory)) {
+            return false;
+        }
+        // Write aside and rename so concurrent runs never read a partial entry
+        std::string path = getPath(key, name);
+        std::string temporaryPath = path + ".tmp" + std::to_string(getpid()) + "."
+                                    + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream file(temporaryPath, std::ios::binary);
+            file << text;
+            if(!file.good()) {
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+}
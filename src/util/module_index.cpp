@@ -0,0 +1,312 @@
+#include <wdb_tui/module_index.h>
+#include <cstring>
+
+namespace wdb {
+    namespace {
+        // Section ids of the wasm binary format
+        const uint8_t CUSTOM_SECTION = 0;
+        const uint8_t IMPORT_SECTION = 2;
+        const uint8_t FUNCTION_SECTION = 3;
+        const uint8_t EXPORT_SECTION = 7;
+        // Subsection id of function names in the name section
+        const uint8_t FUNCTION_NAMES = 1;
+        // External kinds of imports and exports
+        const uint8_t FUNCTION_KIND = 0;
+        const uint8_t TABLE_KIND = 1;
+        const uint8_t MEMORY_KIND = 2;
+        const uint8_t GLOBAL_KIND = 3;
+        const uint8_t TAG_KIND = 4;
+
+        /**
+         * Read values of a wasm binary, every read fails past the end
+         */
+        class BinaryReader {
+        public:
+            BinaryReader(const uint8_t *data, size_t size) : m_data(data), m_end(data + size) {}
+
+            bool atEnd() const { return m_data == m_end; }
+
+            bool readByte(uint8_t &value) {
+                if(m_data == m_end) {
+                    return false;
+                }
+                value = *m_data++;
+                return true;
+            }
+
+            bool readU64(uint64_t &value) {
+                value = 0;
+                for(int shift=0; shift < 64; shift += 7) {
+                    uint8_t byte;
+                    if(!readByte(byte)) {
+                        return false;
+                    }
+                    value |= (uint64_t) (byte & 0x7f) << shift;
+                    if((byte & 0x80) == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool readU32(uint32_t &value) {
+                uint64_t wide;
+                if(!readU64(wide) || wide > UINT32_MAX) {
+                    return false;
+                }
+                value = (uint32_t) wide;
+                return true;
+            }
+
+            bool readName(std::string &name) {
+                uint32_t length;
+                if(!readU32(length) || length > (size_t) (m_end - m_data)) {
+                    return false;
+                }
+                name.assign((const char*) m_data, length);
+                m_data += length;
+                return true;
+            }
+
+            bool readLimits() {
+                uint32_t flags;
+                uint64_t limit;
+                // Maximum is present if the lowest flag is set
+                return readU32(flags) && readU64(limit) && ((flags & 1) == 0 || readU64(limit));
+            }
+
+            /**
+             * Split off the next bytes into their own reader
+             */
+            bool readSection(uint32_t size, BinaryReader &section) {
+                if(size > (size_t) (m_end - m_data)) {
+                    return false;
+                }
+                section = BinaryReader(m_data, size);
+                m_data += size;
+                return true;
+            }
+        private:
+            const uint8_t *m_data;
+            const uint8_t *m_end;
+        };
+
+        /**
+         * Skip the description of an imported table, memory, global or tag
+         */
+        bool SkipImport(BinaryReader &reader, uint8_t kind) {
+            uint8_t byte;
+            uint32_t index;
+            switch (kind) {
+                case TABLE_KIND:
+                    return reader.readByte(byte) && reader.readLimits();
+                case MEMORY_KIND:
+                    return reader.readLimits();
+                case GLOBAL_KIND:
+                    return reader.readByte(byte) && reader.readByte(byte);
+                case TAG_KIND:
+                    return reader.readByte(byte) && reader.readU32(index);
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * Read the function names subsection of the name section
+         */
+        bool ReadFunctionNames(BinaryReader &reader, std::unordered_map<wabt::Index, std::string> &names) {
+            while(!reader.atEnd()) {
+                uint8_t id;
+                uint32_t size;
+                BinaryReader subsection(nullptr, 0);
+                if(!reader.readByte(id) || !reader.readU32(size) || !reader.readSection(size, subsection)) {
+                    return false;
+                }
+                if(id != FUNCTION_NAMES) {
+                    continue;
+                }
+                uint32_t count;
+                if(!subsection.readU32(count)) {
+                    return false;
+                }
+                for(uint32_t i=0; i < count; i++) {
+                    uint32_t index;
+                    std::string name;
+                    if(!subsection.readU32(index) || !subsection.readName(name)) {
+                        return false;
+                    }
+                    names[index] = name;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool ModuleIndex::readBinary(const uint8_t *data, size_t size) {
+        static const uint8_t header[] = {0x00, 'a', 's', 'm', 0x01, 0x00, 0x00, 0x00};
+        m_hasBinary = false;
+        m_importedFunctionCount = 0;
+        m_definedFunctionCount = 0;
+        m_binaryExports.clear();
+        m_functionNames.clear();
+        if(!data || size < sizeof(header) || std::memcmp(data, header, sizeof(header)) != 0) {
+            return false;
+        }
+        BinaryReader reader(data + sizeof(header), size - sizeof(header));
+        while(!reader.atEnd()) {
+            uint8_t id;
+            uint32_t sectionSize;
+            BinaryReader section(nullptr, 0);
+            if(!reader.readByte(id) || !reader.readU32(sectionSize) || !reader.readSection(sectionSize, section)) {
+                return false;
+            }
+            uint32_t count;
+            if(id == IMPORT_SECTION) {
+                if(!section.readU32(count)) {
+                    return false;
+                }
+                for(uint32_t i=0; i < count; i++) {
+                    std::string module, field;
+                    uint8_t kind;
+                    uint32_t type;
+                    if(!section.readName(module) || !section.readName(field) || !section.readByte(kind)) {
+                        return false;
+                    }
+                    if(kind == FUNCTION_KIND) {
+                        if(!section.readU32(type)) {
+                            return false;
+                        }
+                        m_importedFunctionCount++;
+                    } else if(!SkipImport(section, kind)) {
+                        return false;
+                    }
+                }
+            } else if(id == FUNCTION_SECTION) {
+                if(!section.readU32(m_definedFunctionCount)) {
+                    return false;
+                }
+            } else if(id == EXPORT_SECTION) {
+                if(!section.readU32(count)) {
+                    return false;
+                }
+                for(uint32_t i=0; i < count; i++) {
+                    std::string name;
+                    uint8_t kind;
+                    uint32_t index;
+                    if(!section.readName(name) || !section.readByte(kind) || !section.readU32(index)) {
+                        return false;
+                    }
+                    if(kind == FUNCTION_KIND) {
+                        m_binaryExports[name] = index;
+                    }
+                }
+            } else if(id == CUSTOM_SECTION) {
+                std::string name;
+                // Names are debug information, a damaged name section only loses them
+                std::unordered_map<wabt::Index, std::string> names;
+                if(section.readName(name) && name == "name" && ReadFunctionNames(section, names)) {
+                    m_functionNames = names;
+                }
+            }
+        }
+        m_hasBinary = true;
+        return true;
+    }
+
+    void ModuleIndex::build(wdb::WdbExecutor *executor) {
+        if(m_built || !executor) {
+            return;
+        }
+        // -2 once exports disagree on where defined functions start
+        int64_t definedBase = -1;
+        for(int i=0; i < executor->GetModuleSize(); i++) {
+            auto currentModule = executor->GetModuleAt(i);
+            bool mainModule = currentModule == executor->GetMainModule();
+            for(auto &currentExport : executor->GetExportedModuleFunctions(currentModule)) {
+                auto func = executor->GetFunction(currentExport.index);
+                auto funcSig = executor->GetFunctionSignature(func->sig_index);
+                Function function;
+                function.module = mainModule ? "<main>" : currentModule->name;
+                function.name = currentExport.name;
+                function.index = currentExport.index;
+                function.params = formatTypes(funcSig->param_types);
+                function.results = formatTypes(funcSig->result_types);
+                function.paramCount = funcSig->param_types.size();
+                function.isHost = func->is_host;
+                function.canRun = executor->CanBeMain(func);
+                // First export wins, as in a linear search
+                if(mainModule && m_mainExports.find(function.name) == m_mainExports.end()) {
+                    m_mainExports[function.name] = m_functions.size();
+                }
+                m_functions.push_back(function);
+                // Locate defined functions from an exported one, they follow each other in the executor
+                auto binaryExport = m_binaryExports.find(currentExport.name);
+                if(mainModule && !function.isHost && binaryExport != m_binaryExports.end()
+                   && binaryExport->second >= m_importedFunctionCount) {
+                    int64_t base = (int64_t) currentExport.index - (binaryExport->second - m_importedFunctionCount);
+                    if(definedBase != -2) {
+                        definedBase = base >= 0 && (definedBase == -1 || definedBase == base) ? base : -2;
+                    }
+                }
+            }
+        }
+        m_definedBase = definedBase >= 0 ? definedBase : -1;
+        m_built = true;
+    }
+
+    wabt::interp::Func* ModuleIndex::getDefinedFunction(wdb::WdbExecutor *executor, wabt::Index index) const {
+        if(!hasDefinedFunctions() || index >= m_definedFunctionCount) {
+            return nullptr;
+        }
+        return executor->GetFunction((wabt::Index) (m_definedBase + index));
+    }
+
+    std::string ModuleIndex::getFunctionName(wabt::Index index) const {
+        auto name = m_functionNames.find(index);
+        return name == m_functionNames.end() ? "" : name->second;
+    }
+
+    const ModuleIndex::Function* ModuleIndex::find(const std::string &name) const {
+        auto entry = m_mainExports.find(name);
+        return entry == m_mainExports.end() ? nullptr : &m_functions[entry->second];
+    }
+
+    wabt::interp::Func* ModuleIndex::getFunction(wdb::WdbExecutor *executor, const std::string &name) const {
+        const Function *function = find(name);
+        return function ? executor->GetFunction(function->index) : nullptr;
+    }
+
+    std::vector<std::string> ModuleIndex::getNames() const {
+        std::vector<std::string> names;
+        for(auto &function : m_functions) {
+            if(function.module == "<main>") {
+                names.push_back(function.name);
+            }
+        }
+        return names;
+    }
+
+    std::vector<std::string> ModuleIndex::getRunnableNames() const {
+        std::vector<std::string> names;
+        for(auto &function : m_functions) {
+            if(function.module == "<main>" && !function.isHost && function.canRun && function.paramCount == 0) {
+                names.push_back(function.name);
+            }
+        }
+        return names;
+    }
+
+    std::string ModuleIndex::formatTypes(const wabt::TypeVector &types) {
+        if(types.empty()) {
+            return "<empty>";
+        }
+        std::string text;
+        for(size_t i=0; i < types.size(); i++) {
+            if(i > 0) {
+                text += ",";
+            }
+            text += wabt::GetTypeName(types[i]);
+        }
+        return text;
+    }
+}
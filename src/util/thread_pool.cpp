@@ -0,0 +1,66 @@
+#include <wdb_tui/thread_pool.h>
+
+namespace wdb {
+    ThreadPool::ThreadPool(int threads) {
+        if(threads <= 0) {
+            threads = getHardwareThreads();
+        }
+        for(int i=0; i < threads; i++) {
+            m_workers.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_taskReady.notify_all();
+        for(auto &worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    int ThreadPool::getHardwareThreads() {
+        unsigned int threads = std::thread::hardware_concurrency();
+        return threads == 0 ? 1 : (int) threads;
+    }
+
+    void ThreadPool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.push_back(std::move(task));
+        }
+        m_taskReady.notify_one();
+    }
+
+    void ThreadPool::wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_tasks.empty() && m_active == 0; });
+    }
+
+    void ThreadPool::work() {
+        while(true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_taskReady.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+                // Drain the queue before stopping
+                if(m_tasks.empty()) {
+                    return;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                m_active++;
+            }
+            task();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_active--;
+                if(m_tasks.empty() && m_active == 0) {
+                    m_idle.notify_all();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <wdb_tui/timings.h>
+#include <iomanip>
+#include <sstream>
+
+namespace wdb {
+    const size_t Timings::IGNORED;
+
+    Timings& Timings::get() {
+        static Timings timings;
+        return timings;
+    }
+
+    size_t Timings::begin(const std::string &name) {
+        if(m_stopped) {
+            return IGNORED;
+        }
+        Phase phase;
+        phase.name = name;
+        phase.depth = m_depth++;
+        m_phases.push_back(phase);
+        return m_phases.size() - 1;
+    }
+
+    void Timings::end(size_t index, uint64_t time) {
+        if(index == IGNORED) {
+            return;
+        }
+        m_phases[index].time = time;
+        m_depth--;
+    }
+
+    void Timings::print(std::ostream &out) const {
+        uint64_t total = 0;
+        for(auto &phase : m_phases) {
+            if(phase.depth == 0) {
+                total += phase.time;
+            }
+        }
+        out << "[Timings]" << std::endl;
+        for(auto &phase : m_phases) {
+            std::string name = std::string((size_t) phase.depth * 2, ' ') + phase.name;
+            out << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+                << std::setw(10) << phase.time / 1e6 << " ms" << std::endl;
+        }
+        out << "  " << std::left << std::setw(28) << "total" << std::right << std::setw(10) << total / 1e6 << " ms"
+            << std::endl;
+    }
+
+    std::string Timings::getSummary() const {
+        std::stringstream ss;
+        ss << "Startup:";
+        for(auto &phase : m_phases) {
+            if(phase.depth == 0) {
+                ss << " " << phase.name << " " << std::fixed << std::setprecision(1) << phase.time / 1e6 << "ms";
+            }
+        }
+        return ss.str();
+    }
+}
@@ -0,0 +1,92 @@
+#include <wdb_tui/xxhash.h>
+#include <cstring>
+
+namespace wdb {
+    namespace {
+        const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+        const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+        const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+        const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+        const uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+        inline uint64_t RotateLeft(uint64_t value, int bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        // Inputs are read as little-endian, as on all supported hosts
+        inline uint64_t Read64(const uint8_t *p) {
+            uint64_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint32_t Read32(const uint8_t *p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t Round(uint64_t accumulator, uint64_t input) {
+            accumulator += input * PRIME_2;
+            accumulator = RotateLeft(accumulator, 31);
+            return accumulator * PRIME_1;
+        }
+
+        inline uint64_t MergeRound(uint64_t accumulator, uint64_t value) {
+            accumulator ^= Round(0, value);
+            return accumulator * PRIME_1 + PRIME_4;
+        }
+    }
+
+    uint64_t XxHash64(const void *data, size_t size, uint64_t seed) {
+        const uint8_t *p = static_cast<const uint8_t*>(data);
+        const uint8_t *end = p + size;
+        uint64_t hash;
+        if(size >= 32) {
+            // Four independent lanes over 32-byte stripes
+            uint64_t v1 = seed + PRIME_1 + PRIME_2;
+            uint64_t v2 = seed + PRIME_2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - PRIME_1;
+            const uint8_t *limit = end - 32;
+            do {
+                v1 = Round(v1, Read64(p));
+                v2 = Round(v2, Read64(p + 8));
+                v3 = Round(v3, Read64(p + 16));
+                v4 = Round(v4, Read64(p + 24));
+                p += 32;
+            } while(p <= limit);
+            hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+            hash = MergeRound(hash, v1);
+            hash = MergeRound(hash, v2);
+            hash = MergeRound(hash, v3);
+            hash = MergeRound(hash, v4);
+        } else {
+            hash = seed + PRIME_5;
+        }
+        hash += (uint64_t) size;
+        // Remaining bytes
+        while(p + 8 <= end) {
+            hash ^= Round(0, Read64(p));
+            hash = RotateLeft(hash, 27) * PRIME_1 + PRIME_4;
+            p += 8;
+        }
+        if(p + 4 <= end) {
+            hash ^= (uint64_t) Read32(p) * PRIME_1;
+            hash = RotateLeft(hash, 23) * PRIME_2 + PRIME_3;
+            p += 4;
+        }
+        while(p < end) {
+            hash ^= (*p) * PRIME_5;
+            hash = RotateLeft(hash, 11) * PRIME_1;
+            p++;
+        }
+        // Avalanche
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
@@ -0,0 +1,50 @@
+#include "test.h"
+#include <wdb_tui/benchmark.h>
+#include <cmath>
+
+namespace {
+    bool near(double value, double expected) {
+        return std::fabs(value - expected) < 1e-3;
+    }
+
+    void testEmpty() {
+        auto statistics = wdb::Benchmark::Statistics::compute({});
+        CHECK(statistics.min == 0 && statistics.max == 0 && statistics.mean == 0);
+    }
+
+    void testSingle() {
+        // No spread can be estimated from one run
+        auto statistics = wdb::Benchmark::Statistics::compute({5});
+        CHECK(statistics.min == 5 && statistics.max == 5 && statistics.median == 5 && statistics.mean == 5);
+        CHECK(statistics.stddev == 0 && statistics.ci95 == 0);
+    }
+
+    void testMedian() {
+        CHECK(wdb::Benchmark::Statistics::compute({9, 1, 5}).median == 5);
+        CHECK(wdb::Benchmark::Statistics::compute({9, 1, 5, 3}).median == 4);
+    }
+
+    void testSpread() {
+        auto statistics = wdb::Benchmark::Statistics::compute({2, 4, 4, 4, 5, 5, 7, 9});
+        CHECK(statistics.min == 2 && statistics.max == 9);
+        CHECK(near(statistics.mean, 5));
+        // Sample standard deviation and Student's t for 7 degrees of freedom
+        CHECK(near(statistics.stddev, std::sqrt(32.0 / 7)));
+        CHECK(near(statistics.ci95, 2.365 * std::sqrt(32.0 / 7) / std::sqrt(8.0)));
+        // Large samples use the normal quantile
+        std::vector<double> values;
+        for(int i=0; i < 100; i++) {
+            values.push_back(i % 2);
+        }
+        statistics = wdb::Benchmark::Statistics::compute(values);
+        CHECK(near(statistics.ci95, 1.96 * statistics.stddev / 10));
+    }
+}
+
+int main() {
+    testEmpty();
+    testSingle();
+    testMedian();
+    testSpread();
+    return wdb::test::report();
+}
@@ -0,0 +1,108 @@
+#include "test.h"
+#include <wdb_tui/command_registry.h>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef wdb::CommandRegistry Registry;
+
+    /**
+     * Build a registry recording the arguments of the last command run
+     * @param last
+     * @return registry
+     */
+    Registry buildRegistry(std::vector<Registry::Argument> &last) {
+        Registry registry;
+        auto record = [&last](const std::vector<Registry::Argument> &arguments) {
+            last = arguments;
+        };
+        registry.add({"break", {"b"}, {Registry::LINE}, "<line>", "Set a breakpoint", record});
+        registry.add({"backtrace", {}, {}, "", "Show the call stack", record});
+        registry.add({"main", {}, {Registry::NAME}, "<func>", "Set the main function", record});
+        registry.add({"print", {"p"}, {Registry::LOCATION}, "<location>", "Print a value", record});
+        registry.setNames({"add", "add_1", "main"});
+        return registry;
+    }
+
+    void testSplit() {
+        auto words = Registry::split("  break\t 12  ");
+        CHECK(words.size() == 2 && words[0] == "break" && words[1] == "12");
+        CHECK(Registry::split(" \t ").empty());
+    }
+
+    void testParseLine() {
+        uint64_t number = 0;
+        CHECK(Registry::parseLine("42", number) && number == 42);
+        CHECK(Registry::parseLine("999999999", number) && number == 999999999);
+        for(const char *text : {"", "0", "007", "-1", "1x", "1000000000"}) {
+            CHECK(!Registry::parseLine(text, number));
+        }
+    }
+
+    void testParseLocation() {
+        Registry::Location location;
+        CHECK(Registry::parseLocation("stack[3].i64", location));
+        CHECK(location.space == "stack" && location.index == 3 && location.type == "i64");
+        CHECK(Registry::parseLocation("memo[65535].v128", location) && location.index == 65535);
+        for(const char *text : {"stack[].i32", "stack[123456].i32", "stack[1].i8", "heap[1].i32", "stack[x].i32",
+                                "stack1].i32", "stack[1]i32", "stack[1]."}) {
+            CHECK(!Registry::parseLocation(text, location));
+        }
+    }
+
+    void testExecute() {
+        std::vector<Registry::Argument> last;
+        Registry registry = buildRegistry(last);
+        std::string error;
+        CHECK(registry.execute("b 12", error) == Registry::EXECUTED);
+        CHECK(last.size() == 1 && last[0].number == 12 && last[0].text == "12");
+        CHECK(registry.execute("p stack[0].f32", error) == Registry::EXECUTED);
+        CHECK(last.size() == 1 && last[0].location.space == "stack" && last[0].location.type == "f32");
+        CHECK(registry.execute("main add_1", error) == Registry::EXECUTED && last[0].text == "add_1");
+        CHECK(registry.execute("   ", error) == Registry::EMPTY);
+        CHECK(registry.execute("jump 3", error) == Registry::NOT_FOUND && !error.empty());
+        // Arguments are checked before the handler runs
+        last.clear();
+        CHECK(registry.execute("break", error) == Registry::INVALID_ARGUMENTS && error == "Usage: break <line>");
+        CHECK(registry.execute("break 0", error) == Registry::INVALID_ARGUMENTS);
+        CHECK(registry.execute("print stack[0]", error) == Registry::INVALID_ARGUMENTS);
+        CHECK(registry.execute("backtrace now", error) == Registry::INVALID_ARGUMENTS);
+        CHECK(last.empty());
+        // A command with the same name replaces the old one and keeps its aliases
+        bool replaced = false;
+        registry.add({"break", {}, {}, "", "Break now", [&replaced](const std::vector<Registry::Argument>&) {
+            replaced = true;
+        }});
+        CHECK(registry.execute("break", error) == Registry::EXECUTED && replaced);
+        CHECK(registry.getHelp().size() == 4);
+    }
+
+    void testComplete() {
+        std::vector<Registry::Argument> last;
+        Registry registry = buildRegistry(last);
+        std::vector<std::string> candidates;
+        // Commands and aliases
+        CHECK(registry.complete("ba", candidates) == "backtrace " && candidates.size() == 1);
+        CHECK(registry.complete("b", candidates) == "b");
+        CHECK(candidates == std::vector<std::string>({"b", "backtrace", "break"}));
+        CHECK(registry.complete("", candidates) == "" && candidates.size() == 6);
+        // NAME arguments use the registered names
+        CHECK(registry.complete("main a", candidates) == "main add");
+        CHECK(candidates == std::vector<std::string>({"add", "add_1"}));
+        CHECK(registry.complete("main ma", candidates) == "main main ");
+        CHECK(registry.complete("main ", candidates) == "main " && candidates.size() == 3);
+        // Other arguments and unknown commands have no candidates
+        CHECK(registry.complete("break 1", candidates) == "break 1" && candidates.empty());
+        CHECK(registry.complete("main add extra", candidates) == "main add extra" && candidates.empty());
+        CHECK(registry.complete("jump a", candidates) == "jump a" && candidates.empty());
+    }
+}
+
+int main() {
+    testSplit();
+    testParseLine();
+    testParseLocation();
+    testExecute();
+    testComplete();
+    return wdb::test::report();
+}
@@ -0,0 +1,87 @@
+#include "test.h"
+#include <wdb_tui/console.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    void testLines() {
+        wdb::Console console;
+        console.write("first\nsec");
+        console.write("ond\n");
+        console.write("open");
+        CHECK(console.getSize() == 3);
+        CHECK(console.getLine(0) == "first" && console.getLine(1) == "second" && console.getLine(2) == "open");
+        // A complete line closes the open one
+        console.addLine("added");
+        console.write("next");
+        CHECK(console.getSize() == 5 && console.getLine(3) == "added" && console.getLine(4) == "next");
+        console.write("\n\n");
+        CHECK(console.getSize() == 6 && console.getLine(5).empty());
+        auto lines = console.getLines(1, 2);
+        CHECK(lines.size() == 2 && lines[0] == "second" && lines[1] == "open");
+        CHECK(console.getLines(5, 10).size() == 1);
+    }
+
+    void testWrapping() {
+        wdb::Console console;
+        const size_t length = wdb::Console::MAX_LINE_LENGTH;
+        console.write(std::string(length * 2 + 3, 'x'));
+        CHECK(console.getSize() == 3);
+        CHECK(console.getLine(0).size() == length && console.getLine(1).size() == length);
+        CHECK(console.getLine(2) == "xxx");
+        // Writes to a full open line start a new line
+        console.clear();
+        console.write(std::string(length, 'y'));
+        console.write("z");
+        CHECK(console.getSize() == 2 && console.getLine(1) == "z");
+    }
+
+    void testRing() {
+        wdb::Console console(3);
+        CHECK(console.getCapacity() == 3);
+        for(int i=0; i < 5; i++) {
+            console.addLine(std::to_string(i));
+        }
+        CHECK(console.getSize() == 3 && console.getDropped() == 2);
+        CHECK(console.getLine(0) == "2" && console.getLine(2) == "4");
+        console.clear();
+        CHECK(console.getSize() == 0);
+        console.write("after");
+        CHECK(console.getSize() == 1 && console.getLine(0) == "after");
+        CHECK(wdb::Console(0).getCapacity() == 1);
+    }
+
+    void testSpill() {
+        std::string path = "/tmp/wdb_tui_console_test_" + std::to_string(getpid()) + ".log";
+        std::remove(path.c_str());
+        {
+            wdb::Console console(2);
+            CHECK(console.setSpillFile(path));
+            console.write("a\nb");
+            console.write("c\n");
+            console.addLine("d");
+            console.write("e");
+            // Cleared and open lines are spilled too
+            console.clear();
+            console.write("f");
+        }
+        std::ifstream file(path);
+        std::stringstream text;
+        text << file.rdbuf();
+        CHECK(text.str() == "a\nbc\nd\ne\nf\n");
+        std::remove(path.c_str());
+        wdb::Console console;
+        CHECK(!console.setSpillFile("/nonexistent/console.log"));
+    }
+}
+
+int main() {
+    testLines();
+    testWrapping();
+    testRing();
+    testSpill();
+    return wdb::test::report();
+}
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Drive wdb_tui --dap through a debug session like an editor would.
+
+Usage: dap_client.py <wdb_tui> <memory_2.wasm>
+"""
+import base64
+import json
+import struct
+import subprocess
+import sys
+
+
+class Client:
+    def __init__(self, command):
+        self.process = subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.PIPE,
+                                        stderr=subprocess.PIPE)
+        self.sequence = 1
+        self.events = []
+
+    def send_raw(self, data):
+        self.process.stdin.write(data)
+        self.process.stdin.flush()
+
+    def send(self, command, arguments=None):
+        message = {"seq": self.sequence, "type": "request", "command": command}
+        if arguments is not None:
+            message["arguments"] = arguments
+        self.sequence += 1
+        body = json.dumps(message).encode()
+        self.send_raw(b"Content-Length: %d\r\n\r\n" % len(body) + body)
+        return message["seq"]
+
+    def read(self):
+        length = None
+        while True:
+            line = self.process.stdout.readline()
+            if not line:
+                raise AssertionError("server closed the output")
+            line = line.strip()
+            if not line:
+                break
+            name, _, value = line.partition(b":")
+            if name == b"Content-Length":
+                length = int(value)
+        if length is None:
+            raise AssertionError("message without Content-Length")
+        return json.loads(self.process.stdout.read(length))
+
+    def request(self, command, arguments=None):
+        """Send a request and return its response, events before it are kept"""
+        seq = self.send(command, arguments)
+        while True:
+            message = self.read()
+            if message["type"] == "event":
+                self.events.append(message)
+            elif message["type"] == "response" and message["request_seq"] == seq:
+                check(message["command"] == command, "response to " + command)
+                check(message["success"], command + " failed: " + message.get("message", ""))
+                return message.get("body", {})
+
+    def event(self, name):
+        """Return the first event of a name, reading until it arrives"""
+        while True:
+            for event in self.events:
+                if event["event"] == name:
+                    self.events.remove(event)
+                    return event.get("body", {})
+            self.events.append(self.read())
+
+    def finish(self):
+        self.process.stdin.close()
+        stderr = self.process.stderr.read().decode()
+        return self.process.wait(), stderr
+
+
+def check(condition, what):
+    if not condition:
+        raise AssertionError(what)
+
+
+def session(wdb_tui, module):
+    client = Client([wdb_tui, "--dap", module])
+    capabilities = client.request("initialize", {"adapterID": "wdb", "linesStartAt1": True})
+    check(capabilities.get("supportsReadMemoryRequest"), "readMemory is supported")
+    client.event("initialized")
+    client.request("launch", {"function": "main", "stopOnEntry": True})
+
+    # Every instruction line verifies, keep the last one
+    source = {"name": "memory_2.wasm", "sourceReference": 1}
+    lines = [{"line": line} for line in range(1, 100)]
+    breakpoints = client.request("setBreakpoints", {"source": source, "breakpoints": lines})["breakpoints"]
+    verified = [breakpoint["line"] for breakpoint in breakpoints if breakpoint["verified"]]
+    check(len(verified) > 1, "instruction lines verify")
+    check(not all(breakpoint["verified"] for breakpoint in breakpoints), "lines past the code do not verify")
+    last = verified[-1]
+    breakpoints = client.request("setBreakpoints", {"source": source, "breakpoints": [{"line": last}]})["breakpoints"]
+    check(breakpoints[0]["verified"], "breakpoint is set again")
+
+    client.request("configurationDone")
+    check(client.event("stopped")["reason"] == "entry", "stops on entry")
+
+    client.request("continue", {"threadId": 1})
+    check(client.event("stopped")["reason"] == "breakpoint", "stops on the breakpoint")
+    frames = client.request("stackTrace", {"threadId": 1})["stackFrames"]
+    check(len(frames) == 1 and frames[0]["line"] == last, "frame is at the breakpoint line")
+
+    scopes = client.request("scopes", {"frameId": 1})["scopes"]
+    check([scope["name"] for scope in scopes] == ["Stack", "Memories"], "stack and memory scopes")
+    memories = client.request("variables", {"variablesReference": scopes[1]["variablesReference"]})["variables"]
+    check(len(memories) == 1 and memories[0]["memoryReference"] == "memory0", "one memory")
+    unknown = client.request("variables", {"variablesReference": 99})["variables"]
+    check(unknown == [], "unknown references have no variables")
+    past = client.request("variables", {"variablesReference": scopes[1]["variablesReference"], "start": 5})
+    check(past["variables"] == [], "pages past the end are empty")
+
+    # The i32.store of 42 at address 0 ran before the last instruction
+    memory = client.request("readMemory", {"memoryReference": "memory0", "offset": 0, "count": 4})
+    check(memory["address"] == "0x0", "read starts at the offset")
+    check(struct.unpack("<i", base64.b64decode(memory["data"]))[0] == 42, "memory holds the stored value")
+    beyond = client.request("readMemory", {"memoryReference": "memory0", "offset": 65534, "count": 4})
+    check(beyond["unreadableBytes"] == 2, "bytes past the memory are unreadable")
+
+    client.request("continue", {"threadId": 1})
+    client.event("exited")
+    client.event("terminated")
+    client.request("disconnect")
+    status, stderr = client.finish()
+    check(status == 0, "disconnect exits 0: " + stderr)
+
+
+def oversized(wdb_tui, module):
+    client = Client([wdb_tui, "--dap", module])
+    client.send_raw(b"Content-Length: 1099511627776\r\n\r\n{}")
+    status, stderr = client.finish()
+    check(status != 0, "an oversized message fails the server")
+    check("exceeds" in stderr, "the oversized message is reported: " + stderr)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    for test in (session, oversized):
+        try:
+            test(sys.argv[1], sys.argv[2])
+        except AssertionError as error:
+            print("FAIL " + test.__name__ + ": " + str(error), file=sys.stderr)
+            return 1
+        print("ok   " + test.__name__)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
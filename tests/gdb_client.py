@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Drive wdb_tui --gdb-server with raw remote protocol packets.
+
+Usage: gdb_client.py <wdb_tui> <memory_2.wasm>
+"""
+import os
+import socket
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def checksum(payload):
+    return "%02x" % (sum(payload) & 0xff)
+
+
+class Client:
+    def __init__(self, command, path):
+        self.process = subprocess.Popen(command, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        for _ in range(100):
+            try:
+                self.socket.connect(path)
+                break
+            except (FileNotFoundError, ConnectionRefusedError):
+                time.sleep(0.05)
+        else:
+            raise AssertionError("server did not listen on " + path)
+        self.input = b""
+        self.ack = True
+
+    def read_byte(self):
+        if not self.input:
+            self.input = self.socket.recv(4096)
+            if not self.input:
+                raise AssertionError("server closed the connection")
+        byte, self.input = self.input[:1], self.input[1:]
+        return byte
+
+    def send_raw(self, data):
+        self.socket.sendall(data)
+
+    def send(self, payload):
+        if isinstance(payload, str):
+            payload = payload.encode()
+        self.send_raw(b"$" + payload + b"#" + checksum(payload).encode())
+        if self.ack:
+            check(self.read_byte() == b"+", "packet acknowledged")
+
+    def read(self):
+        """Read the next packet that is not console output"""
+        while True:
+            check(self.read_byte() == b"$", "packet start")
+            payload = b""
+            byte = self.read_byte()
+            while byte != b"#":
+                payload += byte
+                byte = self.read_byte()
+            digits = self.read_byte() + self.read_byte()
+            check(digits.decode() == checksum(payload), "reply checksum")
+            if self.ack:
+                self.send_raw(b"+")
+            if payload.startswith(b"O") and payload != b"OK":
+                continue
+            return payload
+
+    def request(self, payload):
+        self.send(payload)
+        return self.read()
+
+    def finish(self):
+        self.socket.close()
+        stderr = self.process.stderr.read().decode()
+        return self.process.wait(), stderr
+
+
+def check(condition, what):
+    if not condition:
+        raise AssertionError(what)
+
+
+def read_pc(client):
+    registers = client.request("g").decode()
+    # pc and sp are 32 bits, then 16 stack slots of 64 bits
+    check(len(registers) == 8 + 8 + 16 * 16, "register packet size")
+    return struct.unpack("<I", bytes.fromhex(registers[:8]))[0]
+
+
+def session(wdb_tui, module, directory):
+    path = os.path.join(directory, "gdb.sock")
+    client = Client([wdb_tui, "--gdb-server", "unix:" + path, "-r", "main", module], path)
+    supported = client.request("qSupported:swbreak+;binary-upload+").decode()
+    check("PacketSize=" in supported and "binary-upload+" in supported, "features are advertised")
+
+    # A corrupted packet is refused and ignored
+    client.send_raw(b"$?#00")
+    check(client.read_byte() == b"-", "bad checksum is refused")
+    check(client.request("?") == b"S05", "stopped at the start")
+    check(client.request("QStartNoAckMode") == b"OK", "no-ack mode accepted")
+    client.ack = False
+
+    description = client.request("qXfer:features:read:target.xml:0,ffff").decode()
+    check(description.startswith("l<?xml") and 'name="stack15"' in description, "target description")
+    check(client.request("qXfer:features:read:target.xml:ffff,10") == b"l", "read past the description")
+
+    # Record the offsets of the first instructions, then restart
+    first = read_pc(client)
+    check(client.request("s") == b"S05", "step stops")
+    second = read_pc(client)
+    check(client.request("s") == b"S05", "step stops")
+    third = read_pc(client)
+    check(first < second < third, "steps advance the pc")
+    check(client.request("qRcmd," + b"main main".hex()) == b"OK", "monitor restarts main")
+    check(read_pc(client) == first, "main restarts at the first instruction")
+
+    check(client.request("Z0,%x,1" % third) == b"OK", "breakpoint set")
+    check(client.request("Z0,ffffff,1") == b"E01", "breakpoint outside the code")
+    check(client.request("Z1,%x,1" % third) == b"", "hardware breakpoints are unsupported")
+    check(client.request("c") == b"S05", "continue stops at the breakpoint")
+    check(read_pc(client) == third, "stopped at the breakpoint")
+    check(client.request("z0,%x,1" % third) == b"OK", "breakpoint removed")
+    check(client.request("vCont;c") == b"W00", "main returns")
+
+    # The i32.store of 42, a '*', at address 0 is escaped in binary replies
+    check(client.request("m0,4") == b"2a000000", "hex memory read")
+    check(client.request("x0,4") == b"b}\x0a\x00\x00\x00", "binary memory read escapes '*'")
+    check(client.request("x0,0") == b"OK", "binary probe")
+    check(client.request("mffff,4") == b"00", "short read at the end of memory")
+    check(client.request("m10000,4") == b"E14", "read past the memory")
+    check(client.request("M0,1:00") == b"", "memory writes are unsupported")
+
+    check(client.request("D") == b"OK", "detach")
+    status, stderr = client.finish()
+    check(status == 0, "detach exits 0: " + stderr)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    with tempfile.TemporaryDirectory() as directory:
+        try:
+            session(sys.argv[1], sys.argv[2], directory)
+        except AssertionError as error:
+            print("FAIL session: " + str(error), file=sys.stderr)
+            return 1
+    print("ok   session")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
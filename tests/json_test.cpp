@@ -0,0 +1,87 @@
+#include "test.h"
+#include <wdb_tui/json.h>
+#include <string>
+
+namespace {
+    bool parses(const std::string &text) {
+        wdb::Json value;
+        return wdb::Json::parse(text, value);
+    }
+
+    void testRoundTrip() {
+        wdb::Json root = wdb::Json::object();
+        root["name"] = "quote \" backslash \\ newline \n tab \t bell \x07";
+        root["time"] = (uint64_t) 12345678;
+        root["ratio"] = 0.1;
+        root["negative"] = -3;
+        root["flag"] = true;
+        root["nothing"] = wdb::Json();
+        root["list"] = wdb::Json::array();
+        root["list"].push(1);
+        root["list"].push("two");
+        for(int indent : {0, 2}) {
+            wdb::Json parsed;
+            CHECK(wdb::Json::parse(root.dump(indent), parsed));
+            CHECK(parsed.dump() == root.dump());
+            CHECK(parsed.get("name").asString() == root.get("name").asString());
+            CHECK(parsed.get("time").asUint() == 12345678);
+            CHECK(parsed.get("ratio").asNumber() == 0.1);
+            CHECK(parsed.get("negative").asInt() == -3);
+            CHECK(parsed.get("flag").asBool());
+            CHECK(parsed.get("nothing").isNull());
+            CHECK(parsed.get("list").size() == 2 && parsed.get("list")[1].asString() == "two");
+        }
+        // Integers are written exactly, not in exponent notation
+        CHECK(root.get("time").dump() == "12345678");
+    }
+
+    void testEscapes() {
+        wdb::Json value;
+        CHECK(wdb::Json::parse("\"\\u00e9\\ud83d\\ude00\\/\"", value));
+        CHECK(value.asString() == "\xc3\xa9\xf0\x9f\x98\x80/");
+        CHECK(!parses("\"\\x\""));
+        CHECK(!parses("\"\\ud83d\\u0041\""));
+        CHECK(!parses("\"open"));
+    }
+
+    void testNumbers() {
+        wdb::Json value;
+        CHECK(wdb::Json::parse("-0.5e+2", value) && value.asNumber() == -50);
+        CHECK(wdb::Json::parse("0", value) && value.asNumber() == 0);
+        // strtod extensions and malformed numbers are rejected
+        for(const char *text : {"nan", "NaN", "inf", "-Infinity", "0x10", "01", "1.", ".5", "-", "+1", "1e", "1e+",
+                                "1e999"}) {
+            CHECK(!parses(text));
+        }
+    }
+
+    void testIntegers() {
+        CHECK(wdb::Json(-1).asUint() == 0);
+        CHECK(wdb::Json(1e30).asUint() == UINT64_MAX);
+        CHECK(wdb::Json(-1e30).asInt() == INT64_MIN);
+        CHECK(wdb::Json(2.9).asInt() == 2);
+        CHECK(wdb::Json("7").asInt() == 0);
+    }
+
+    void testStructure() {
+        CHECK(parses(" { \"a\" : [ 1 , { } , [ ] ] } "));
+        CHECK(!parses("{\"a\" 1}"));
+        CHECK(!parses("[1,]"));
+        CHECK(!parses("[1] 2"));
+        CHECK(!parses(""));
+        // Nesting is bounded
+        CHECK(parses(std::string(200, '[') + std::string(200, ']')));
+        CHECK(!parses(std::string(100000, '[') + std::string(100000, ']')));
+        wdb::Json value;
+        CHECK(wdb::Json::parse("{\"a\":1}", value) && value.get("missing").isNull() && !value.has("missing"));
+    }
+}
+
+int main() {
+    testRoundTrip();
+    testEscapes();
+    testNumbers();
+    testIntegers();
+    testStructure();
+    return wdb::test::report();
+}
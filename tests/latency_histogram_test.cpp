@@ -0,0 +1,69 @@
+#include "test.h"
+#include <wdb_tui/latency_histogram.h>
+
+namespace {
+    void testEmpty() {
+        wdb::LatencyHistogram histogram;
+        CHECK(histogram.getCount() == 0);
+        CHECK(histogram.getMin() == 0);
+        CHECK(histogram.getMax() == 0);
+        CHECK(histogram.getPercentile(50) == 0);
+    }
+
+    void testBuckets() {
+        // Small values are exact, larger ones stay within 1/SUB_BUCKETS
+        for(uint64_t value=0; value < (1 << 20); value += 1 + value / 7) {
+            uint64_t bound = wdb::LatencyHistogram::bucketUpperBound(wdb::LatencyHistogram::bucketIndex(value));
+            CHECK(bound >= value);
+            CHECK(bound - value <= value / wdb::LatencyHistogram::SUB_BUCKETS);
+        }
+        CHECK(wdb::LatencyHistogram::bucketIndex(wdb::LatencyHistogram::MAX_VALUE)
+              == wdb::LatencyHistogram::BUCKETS - 1);
+    }
+
+    void testPercentiles() {
+        wdb::LatencyHistogram histogram;
+        for(uint64_t value=1; value <= 100; value++) {
+            histogram.record(value);
+        }
+        CHECK(histogram.getCount() == 100);
+        CHECK(histogram.getMin() == 1);
+        CHECK(histogram.getMax() == 100);
+        CHECK(histogram.getPercentile(0) == 1);
+        CHECK(histogram.getPercentile(50) >= 50 && histogram.getPercentile(50) <= 53);
+        CHECK(histogram.getPercentile(99) >= 99);
+        CHECK(histogram.getPercentile(100) == 100);
+    }
+
+    void testMerge() {
+        wdb::LatencyHistogram first;
+        wdb::LatencyHistogram second;
+        first.record(10);
+        second.record(3);
+        second.record(7000);
+        first.merge(second);
+        CHECK(first.getCount() == 3);
+        CHECK(first.getMin() == 3);
+        CHECK(first.getMax() == 7000);
+        first.reset();
+        CHECK(first.getCount() == 0);
+        CHECK(first.getMax() == 0);
+    }
+
+    void testOverflow() {
+        // Values past the range land in the last bucket, the maximum stays exact
+        wdb::LatencyHistogram histogram;
+        histogram.record(wdb::LatencyHistogram::MAX_VALUE * 4);
+        CHECK(histogram.getMax() == wdb::LatencyHistogram::MAX_VALUE * 4);
+        CHECK(histogram.getPercentile(100) == wdb::LatencyHistogram::MAX_VALUE);
+    }
+}
+
+int main() {
+    testEmpty();
+    testBuckets();
+    testPercentiles();
+    testMerge();
+    testOverflow();
+    return wdb::test::report();
+}
@@ -0,0 +1,90 @@
+#include "test.h"
+#include <wdb_tui/module_cache.h>
+#include <wdb_tui/xxhash.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace {
+    void testXxHash() {
+        // Reference values of XXH64
+        CHECK(wdb::XxHash64("", 0) == 0xef46db3751d8e999ULL);
+        CHECK(wdb::XxHash64("a", 1) == 0xd24ec4f1a98c6e5bULL);
+        CHECK(wdb::XxHash64("abc", 3) == 0x44bc2cf5ad770999ULL);
+        const char *text = "Nobody inspects the spammish repetition";
+        CHECK(wdb::XxHash64(text, std::strlen(text)) == 0xfbcea83c8a378bf1ULL);
+        CHECK(wdb::XxHash64("", 0, 1) != wdb::XxHash64("", 0));
+    }
+
+    void testKeys() {
+        const uint8_t first[] = {0x00, 'a', 's', 'm'};
+        const uint8_t second[] = {0x00, 'a', 's', 'n'};
+        std::string key = wdb::ModuleCache::getKey(first, sizeof(first));
+        CHECK(key.size() == 16);
+        CHECK(key == wdb::ModuleCache::getKey(first, sizeof(first)));
+        CHECK(key != wdb::ModuleCache::getKey(second, sizeof(second)));
+        // Keys are seeded with the loader version
+        char unseeded[17];
+        std::snprintf(unseeded, sizeof(unseeded), "%016llx", (unsigned long long) wdb::XxHash64(first, sizeof(first)));
+        CHECK(key != unseeded);
+        CHECK(std::strlen(wdb::ModuleCache::getLoaderVersion()) > 0);
+    }
+
+    void testFileKeys(const std::string &directory) {
+        std::string path = directory + "/module.wasm";
+        CHECK(wdb::ModuleCache::getFileKey(path).empty());
+        std::ofstream(path) << "module";
+        std::string key = wdb::ModuleCache::getFileKey(path);
+        CHECK(!key.empty());
+        CHECK(key == wdb::ModuleCache::getFileKey(path));
+        // Content keys and file keys never collide
+        CHECK(key != wdb::ModuleCache::getKey(reinterpret_cast<const uint8_t*>("module"), 6));
+        std::ofstream(path) << "a rebuilt module";
+        CHECK(key != wdb::ModuleCache::getFileKey(path));
+        std::remove(path.c_str());
+    }
+
+    void testEntries(const std::string &directory) {
+        // The directory is created on the first write
+        wdb::ModuleCache cache(directory + "/nested/cache");
+        CHECK(cache.isEnabled());
+        std::string text;
+        CHECK(!cache.loadText("0123456789abcdef", "wat", text));
+        CHECK(cache.saveText("0123456789abcdef", "wat", "(module)"));
+        CHECK(cache.loadText("0123456789abcdef", "wat", text) && text == "(module)");
+        CHECK(!cache.loadText("0123456789abcdef", "other", text));
+        CHECK(!cache.loadText("fedcba9876543210", "wat", text));
+        std::string error;
+        CHECK(!cache.isInvalid("fedcba9876543210", error));
+        cache.setInvalid("fedcba9876543210", "Error reading file: bad.wasm");
+        CHECK(cache.isInvalid("fedcba9876543210", error) && error == "Error reading file: bad.wasm");
+        // Files that could not be keyed are never cached
+        CHECK(!cache.saveText("", "wat", "(module)"));
+        CHECK(!cache.loadText("", "wat", text));
+    }
+
+    void testDisabled() {
+        wdb::ModuleCache cache("");
+        std::string text;
+        CHECK(!cache.isEnabled());
+        CHECK(!cache.saveText("0123456789abcdef", "wat", "(module)"));
+        CHECK(!cache.loadText("0123456789abcdef", "wat", text));
+    }
+}
+
+int main() {
+    char directory[] = "/tmp/wdb_tui_cache_test_XXXXXX";
+    if(!mkdtemp(directory)) {
+        std::cerr << "Cannot create a temporary directory" << std::endl;
+        return 1;
+    }
+    testXxHash();
+    testKeys();
+    testFileKeys(directory);
+    testEntries(directory);
+    testDisabled();
+    std::system(("rm -rf " + std::string(directory)).c_str());
+    return wdb::test::report();
+}
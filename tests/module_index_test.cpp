@@ -0,0 +1,92 @@
+#include "test.h"
+#include <wdb_tui/module_index.h>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef std::vector<uint8_t> Bytes;
+
+    void append(Bytes &bytes, const std::string &name) {
+        bytes.push_back((uint8_t) name.size());
+        bytes.insert(bytes.end(), name.begin(), name.end());
+    }
+
+    void appendSection(Bytes &module, uint8_t id, const Bytes &section) {
+        module.push_back(id);
+        module.push_back((uint8_t) section.size());
+        module.insert(module.end(), section.begin(), section.end());
+    }
+
+    /**
+     * Build a module importing one function and defining two,
+     * the second is exported as "run" and named in the name section
+     */
+    Bytes buildModule() {
+        Bytes module = {0x00, 'a', 's', 'm', 0x01, 0x00, 0x00, 0x00};
+        // Import "env" "log" as a function of type 0
+        Bytes imports = {1};
+        append(imports, "env");
+        append(imports, "log");
+        imports.push_back(0x00);
+        imports.push_back(0);
+        appendSection(module, 2, imports);
+        appendSection(module, 3, {2, 0, 0});
+        // Export function 2 as "run"
+        Bytes exports = {1};
+        append(exports, "run");
+        exports.push_back(0x00);
+        exports.push_back(2);
+        appendSection(module, 7, exports);
+        // Name function 1 in the function names subsection
+        Bytes names;
+        append(names, "name");
+        Bytes functionNames = {1, 1};
+        append(functionNames, "helper");
+        names.push_back(1);
+        names.push_back((uint8_t) functionNames.size());
+        names.insert(names.end(), functionNames.begin(), functionNames.end());
+        appendSection(module, 0, names);
+        return module;
+    }
+
+    void testLayout() {
+        Bytes module = buildModule();
+        wdb::ModuleIndex index;
+        CHECK(index.readBinary(module.data(), module.size()));
+        CHECK(index.getImportedFunctionCount() == 1);
+        CHECK(index.getDefinedFunctionCount() == 2);
+        CHECK(index.getFunctionName(1) == "helper");
+        CHECK(index.getFunctionName(2).empty());
+        // Enumeration also needs the executor's exports
+        CHECK(!index.hasDefinedFunctions());
+    }
+
+    void testMalformed() {
+        Bytes module = buildModule();
+        wdb::ModuleIndex index;
+        CHECK(!index.readBinary(module.data(), 4));
+        // Cut inside the export section
+        CHECK(!index.readBinary(module.data(), 30));
+        module[1] = 'b';
+        CHECK(!index.readBinary(module.data(), module.size()));
+        CHECK(!index.readBinary(nullptr, 0));
+    }
+
+    void testDamagedNames() {
+        // A damaged name section only loses the names
+        Bytes module = buildModule();
+        // Claim more names than the subsection holds
+        module[module.size() - 9] = 5;
+        wdb::ModuleIndex index;
+        CHECK(index.readBinary(module.data(), module.size()));
+        CHECK(index.getDefinedFunctionCount() == 2);
+        CHECK(index.getFunctionName(1).empty());
+    }
+}
+
+int main() {
+    testLayout();
+    testMalformed();
+    testDamagedNames();
+    return wdb::test::report();
+}
@@ -0,0 +1,136 @@
+#include "test.h"
+#include <wdb_tui/profile_snapshot.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    /**
+     * Write a snapshot file with function records
+     * @param name file name suffix
+     * @param functions JSON array of function records
+     * @return path
+     */
+    std::string writeProfile(const std::string &name, const std::string &functions,
+                             const std::string &header = "\"format\": \"wdb-profile\", \"version\": 1") {
+        std::string path = "/tmp/wdb_tui_snapshot_test_" + std::to_string(getpid()) + "_" + name + ".json";
+        std::ofstream file(path);
+        file << "{" << header << ", \"function\": \"main\", \"instructions\": 1000, \"time_ns\": 500,"
+             << " \"opcodes\": [], \"calls\": [], \"functions\": " << functions << "}";
+        return path;
+    }
+
+    bool load(const std::string &path, wdb::ProfileSnapshot &snapshot) {
+        std::string error;
+        bool loaded = snapshot.load(path, error);
+        std::remove(path.c_str());
+        return loaded;
+    }
+
+    const wdb::ProfileSnapshot::Delta* findDelta(const std::vector<wdb::ProfileSnapshot::Delta> &deltas,
+                                                 const std::string &name) {
+        for(auto &delta : deltas) {
+            if(delta.name == name) {
+                return &delta;
+            }
+        }
+        return nullptr;
+    }
+
+    void testLoad() {
+        wdb::ProfileSnapshot snapshot;
+        CHECK(load(writeProfile("load", "[{\"name\": \"a\", \"count\": 2, \"time_ns\": 100, \"instructions\": 40}]"),
+                   snapshot));
+        CHECK(snapshot.getFunction() == "main");
+        CHECK(snapshot.getInstructionCount() == 1000);
+        CHECK(snapshot.getFunctions().size() == 1);
+        CHECK(snapshot.getFunctions()[0].totalTime == 100 && snapshot.getFunctions()[0].instructions == 40);
+        // Saved snapshots load back unchanged
+        std::string path = "/tmp/wdb_tui_snapshot_test_" + std::to_string(getpid()) + "_saved.json";
+        CHECK(snapshot.save(path));
+        wdb::ProfileSnapshot saved;
+        CHECK(load(path, saved));
+        CHECK(saved.getFunctions().size() == 1 && saved.getFunctions()[0].name == "a");
+        CHECK(saved.getFunctions()[0].count == 2 && saved.getElapsedTime() == 500);
+    }
+
+    void testLoadErrors() {
+        wdb::ProfileSnapshot snapshot;
+        std::string error;
+        CHECK(!snapshot.load("/nonexistent/profile.json", error) && !error.empty());
+        CHECK(!load(writeProfile("format", "[]", "\"format\": \"other\", \"version\": 1"), snapshot));
+        CHECK(!load(writeProfile("version", "[]", "\"format\": \"wdb-profile\", \"version\": 99"), snapshot));
+        CHECK(!load(writeProfile("records", "{}"), snapshot));
+        CHECK(!load(writeProfile("name", "[{\"count\": 1}]"), snapshot));
+        CHECK(!load(writeProfile("number", "[{\"name\": \"a\", \"count\": nan}]"), snapshot));
+    }
+
+    void testDiff() {
+        wdb::ProfileSnapshot base;
+        wdb::ProfileSnapshot current;
+        CHECK(load(writeProfile("base", "[{\"name\": \"a\", \"count\": 1, \"time_ns\": 100},"
+                                        " {\"name\": \"b\", \"count\": 1, \"time_ns\": 50}]"), base));
+        CHECK(load(writeProfile("current", "[{\"name\": \"a\", \"count\": 3, \"time_ns\": 150},"
+                                           " {\"name\": \"c\", \"count\": 1, \"time_ns\": 20}]"), current));
+        auto deltas = wdb::ProfileSnapshot::diff(base, current);
+        CHECK(deltas.size() == 3);
+        // Largest time regression first
+        CHECK(deltas.front().name == "a" && deltas.back().name == "b");
+        auto matched = findDelta(deltas, "a");
+        CHECK(matched && matched->inBase && matched->inCurrent);
+        CHECK(matched && matched->getCountDelta() == 2 && matched->getTimeDelta() == 50);
+        CHECK(matched && matched->getRelativeTimeDelta() == 50);
+        // Unmatched records are kept and marked
+        auto removed = findDelta(deltas, "b");
+        CHECK(removed && removed->inBase && !removed->inCurrent && removed->getTimeDelta() == -50);
+        auto added = findDelta(deltas, "c");
+        CHECK(added && !added->inBase && added->inCurrent && added->getRelativeTimeDelta() == 100);
+        CHECK(added && added->category == "Function");
+    }
+
+    const wdb::ProfileSnapshot::Check* findCheck(const std::vector<wdb::ProfileSnapshot::Check> &checks,
+                                                 const std::string &name, const std::string &metric) {
+        for(auto &check : checks) {
+            if(check.name == name && check.metric == metric) {
+                return &check;
+            }
+        }
+        return nullptr;
+    }
+
+    void testCompare() {
+        wdb::ProfileSnapshot base;
+        wdb::ProfileSnapshot current;
+        CHECK(load(writeProfile("compare_base", "[{\"name\": \"a\", \"time_ns\": 100, \"instructions\": 40},"
+                                                " {\"name\": \"b\", \"time_ns\": 0, \"instructions\": 0},"
+                                                " {\"name\": \"gone\", \"time_ns\": 1, \"instructions\": 10}]"),
+                   base));
+        CHECK(load(writeProfile("compare_current", "[{\"name\": \"a\", \"time_ns\": 100, \"instructions\": 50},"
+                                                   " {\"name\": \"b\", \"time_ns\": 9, \"instructions\": 5}]"),
+                   current));
+        auto checks = wdb::ProfileSnapshot::compare(base, current, 5);
+        // Regressions first, then missing functions
+        CHECK(checks.front().name == "a" && checks.front().metric == "instructions" && checks.front().regressed);
+        CHECK(checks.size() > 1 && checks[1].missing && checks[1].name == "gone" && checks[1].base == 10);
+        CHECK(findCheck(checks, "a", "time") && !findCheck(checks, "a", "time")->regressed);
+        CHECK(findCheck(checks, "<total>", "instructions") && !findCheck(checks, "<total>", "instructions")->regressed);
+        // A zero baseline is never an infinite regression
+        auto zero = findCheck(checks, "b", "instructions");
+        CHECK(zero && !zero->regressed && zero->getRelativeDelta() == 0);
+        // Functions under MIN_TIME_SHARE of the run are not gated on time
+        CHECK(!findCheck(checks, "b", "time"));
+        // The threshold is a relative increase
+        auto relaxed = wdb::ProfileSnapshot::compare(base, current, 30);
+        CHECK(!findCheck(relaxed, "a", "instructions")->regressed);
+        CHECK(findCheck(relaxed, "a", "instructions")->getRelativeDelta() == 25);
+    }
+}
+
+int main() {
+    testLoad();
+    testLoadErrors();
+    testDiff();
+    testCompare();
+    return wdb::test::report();
+}
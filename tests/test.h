@@ -0,0 +1,40 @@
+#ifndef WDB_TUI_TESTS_TEST_H
+#define WDB_TUI_TESTS_TEST_H
+
+#include <iostream>
+
+namespace wdb {
+    namespace test {
+        /**
+         * Get number of failed checks
+         * @return count
+         */
+        inline int& getFailures() {
+            static int failures = 0;
+            return failures;
+        }
+
+        /**
+         * Print the outcome of a test executable
+         * @return exit status
+         */
+        inline int report() {
+            if(getFailures() > 0) {
+                std::cerr << getFailures() << " check(s) failed" << std::endl;
+                return 1;
+            }
+            return 0;
+        }
+    }
+}
+
+// Record a failed condition and keep running the remaining checks
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            wdb::test::getFailures()++; \
+        } \
+    } while(0)
+
+#endif